@@ -1,6 +1,10 @@
 #ifndef CLASSMAIN_H
 #define CLASSMAIN_H
 #include "header.h"
+#include "format.h"
+#include "mappedfile.h"
+#include "slotmap.h"
+#include "texttable.h"
 
 // Forward declarations to resolve circular dependencies
 class Employee;
@@ -11,9 +15,8 @@ class Project;
 template <typename T>
 std::string to_string_with_precision(const T a_value, const int n = 2)
 {
-    std::ostringstream out;
-    out << std::fixed << std::setprecision(n) << a_value;
-    return out.str();
+    char buffer[formatBufferSize];
+    return std::string(buffer, formatFixed(buffer, buffer + sizeof(buffer), static_cast<double>(a_value), n));
 }
 
 // Enum for user roles
@@ -43,21 +46,449 @@ struct Date
 
     string toString() const
     {
-        return to_string(year) + "-" + (month < 10 ? "0" : "") + to_string(month) + "-" + (day < 10 ? "0" : "") + to_string(day);
+        char buffer[formatBufferSize];
+        return string(buffer, formatIsoDate(buffer, buffer + sizeof(buffer), year, month, day));
+    }
+
+    static bool isLeapYear(int year)
+    {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+
+    static int daysInMonth(int year, int month)
+    {
+        static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        return (month == 2 && isLeapYear(year)) ? 29 : days[month - 1];
+    }
+
+    static int daysInYear(int year) { return isLeapYear(year) ? 366 : 365; }
+
+    bool isValid() const
+    {
+        return month >= 1 && month <= 12 && day >= 1 && day <= daysInMonth(year, month);
+    }
+
+    // 0-based day within the year; the date must be valid
+    int dayOfYear() const
+    {
+        int days = day - 1;
+        for (int m = 1; m < month; m++)
+            days += daysInMonth(year, m);
+        return days;
+    }
+
+    static Date fromDayOfYear(int year, int dayIndex)
+    {
+        int month = 1;
+        while (dayIndex >= daysInMonth(year, month))
+            dayIndex -= daysInMonth(year, month++);
+        return Date{year, month, dayIndex + 1};
+    }
+};
+
+// Attendance of one employee as per-year bitmaps: one bit per day says
+// whether attendance was recorded, a second whether the employee was
+// present. A year costs 96 bytes however many days are recorded, and
+// counts over a date range are popcounts over whole words.
+class AttendanceCalendar
+{
+private:
+    static constexpr int wordsPerYear = 6; // 6 * 64 bits >= 366 days
+
+    struct YearBits
+    {
+        array<uint64_t, wordsPerYear> recorded{};
+        array<uint64_t, wordsPerYear> present{};
+    };
+
+    map<int, YearBits> years;
+
+    // Bits [from, to] of a word range, counted with popcount
+    static size_t countBits(const array<uint64_t, wordsPerYear> &words, int from, int to)
+    {
+        size_t total = 0;
+        for (int w = from / 64; w <= to / 64; w++)
+        {
+            uint64_t mask = ~uint64_t(0);
+            if (w == from / 64)
+                mask &= ~uint64_t(0) << (from % 64);
+            if (w == to / 64 && to % 64 != 63)
+                mask &= (uint64_t(1) << (to % 64 + 1)) - 1;
+            total += bitset<64>(words[w] & mask).count();
+        }
+        return total;
+    }
+
+public:
+    // Records or overwrites a day. Returns false for an invalid date.
+    bool set(const Date &date, bool isPresent)
+    {
+        if (!date.isValid())
+            return false;
+        int d = date.dayOfYear();
+        YearBits &bits = years[date.year];
+        uint64_t bit = uint64_t(1) << (d % 64);
+        bits.recorded[d / 64] |= bit;
+        if (isPresent)
+            bits.present[d / 64] |= bit;
+        else
+            bits.present[d / 64] &= ~bit;
+        return true;
+    }
+
+    // Whether the day was recorded; if so, `isPresent` receives its value
+    bool get(const Date &date, bool &isPresent) const
+    {
+        if (!date.isValid())
+            return false;
+        auto it = years.find(date.year);
+        if (it == years.end())
+            return false;
+        int d = date.dayOfYear();
+        uint64_t bit = uint64_t(1) << (d % 64);
+        if (!(it->second.recorded[d / 64] & bit))
+            return false;
+        isPresent = (it->second.present[d / 64] & bit) != 0;
+        return true;
+    }
+
+    // Recorded and present days in the inclusive range [from, to]
+    void count(const Date &from, const Date &to, size_t &recordedDays, size_t &presentDays) const
+    {
+        recordedDays = presentDays = 0;
+        if (to < from)
+            return;
+        for (auto it = years.lower_bound(from.year); it != years.end() && it->first <= to.year; ++it)
+        {
+            int first = (it->first == from.year) ? from.dayOfYear() : 0;
+            int last = (it->first == to.year) ? to.dayOfYear() : Date::daysInYear(it->first) - 1;
+            recordedDays += countBits(it->second.recorded, first, last);
+            presentDays += countBits(it->second.present, first, last);
+        }
+    }
+
+    // Longest run of consecutive recorded days marked absent in [from, to].
+    // Days without a record (weekends, holidays) neither break nor extend a run.
+    int longestAbsenceStreak(const Date &from, const Date &to) const
+    {
+        int longest = 0, current = 0;
+        if (to < from)
+            return 0;
+        for (auto it = years.lower_bound(from.year); it != years.end() && it->first <= to.year; ++it)
+        {
+            int first = (it->first == from.year) ? from.dayOfYear() : 0;
+            int last = (it->first == to.year) ? to.dayOfYear() : Date::daysInYear(it->first) - 1;
+            const YearBits &bits = it->second;
+            for (int w = first / 64; w <= last / 64; w++)
+            {
+                uint64_t word = bits.recorded[w];
+                if (w == first / 64)
+                    word &= ~uint64_t(0) << (first % 64);
+                if (w == last / 64 && last % 64 != 63)
+                    word &= (uint64_t(1) << (last % 64 + 1)) - 1;
+                if (word == 0)
+                    continue;
+                if ((word & bits.present[w]) == 0)
+                {
+                    // Whole word absent: extend the run without visiting each day
+                    current += static_cast<int>(bitset<64>(word).count());
+                    longest = max(longest, current);
+                    continue;
+                }
+                while (word)
+                {
+                    uint64_t bit = word & (~word + 1);
+                    word &= word - 1;
+                    current = (bits.present[w] & bit) ? 0 : current + 1;
+                    longest = max(longest, current);
+                }
+            }
+        }
+        return longest;
+    }
+
+    // Number of recorded days
+    size_t size() const
+    {
+        size_t total = 0;
+        for (const auto &year : years)
+            total += countBits(year.second.recorded, 0, wordsPerYear * 64 - 1);
+        return total;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    // Calls fn(date, present) for every recorded day in date order
+    template <typename Fn>
+    void forEach(Fn fn) const
+    {
+        for (const auto &year : years)
+        {
+            for (int w = 0; w < wordsPerYear; w++)
+            {
+                uint64_t word = year.second.recorded[w];
+                while (word)
+                {
+                    int bit = static_cast<int>(bitset<64>((word & (~word + 1)) - 1).count()); // Lowest set bit
+                    word &= word - 1;
+                    int d = w * 64 + bit;
+                    fn(Date::fromDayOfYear(year.first, d), (year.second.present[w] >> bit & 1) != 0);
+                }
+            }
+        }
+    }
+};
+
+// Amount of money held as a whole number of cents. Sums of cents are exact,
+// so totals and averages do not depend on the order of summation and can
+// be split across threads.
+class Money
+{
+private:
+    int64_t cents;
+
+    constexpr explicit Money(int64_t minorUnits) : cents(minorUnits) {}
+
+public:
+    constexpr Money() : cents(0) {}
+
+    static constexpr Money fromCents(int64_t minorUnits) { return Money(minorUnits); }
+    // Throws out_of_range if the amount in cents does not fit in int64
+    static Money fromDouble(double amount)
+    {
+        double cents = amount * 100;
+        if (!(fabs(cents) < 9.2e18)) // Also rejects NaN
+            throw out_of_range("amount out of range");
+        return Money(llround(cents));
+    }
+
+    // Parses a decimal amount such as "1234.5" or "-3.999" exactly,
+    // rounding to the nearest cent. Throws invalid_argument like stod, and
+    // out_of_range if the amount in cents does not fit in int64.
+    static Money parse(const string &text)
+    {
+        // Largest whole part that leaves room for the cents and rounding
+        constexpr int64_t maxWhole = (INT64_MAX - 100) / 100;
+        size_t i = 0;
+        bool negative = false;
+        if (i < text.size() && (text[i] == '-' || text[i] == '+'))
+            negative = (text[i++] == '-');
+        int64_t whole = 0, fraction = 0;
+        int fractionDigits = 0;
+        bool roundUp = false, anyDigit = false;
+        for (; i < text.size() && isdigit(static_cast<unsigned char>(text[i])); i++, anyDigit = true)
+        {
+            int digit = text[i] - '0';
+            if (whole > (maxWhole - digit) / 10)
+                throw out_of_range("amount out of range: " + text);
+            whole = whole * 10 + digit;
+        }
+        if (i < text.size() && text[i] == '.')
+        {
+            for (i++; i < text.size() && isdigit(static_cast<unsigned char>(text[i])); i++, anyDigit = true)
+            {
+                if (fractionDigits < 2)
+                    fraction = fraction * 10 + (text[i] - '0');
+                else if (fractionDigits == 2)
+                    roundUp = text[i] >= '5';
+                fractionDigits++;
+            }
+        }
+        if (!anyDigit)
+            throw invalid_argument("not an amount: " + text);
+        if (i != text.size())
+        {
+            // Exponent notation and the like, but only if it is the whole text
+            size_t used = 0;
+            double value = stod(text, &used);
+            if (used != text.size())
+                throw invalid_argument("not an amount: " + text);
+            return fromDouble(value);
+        }
+        for (; fractionDigits < 2; fractionDigits++)
+            fraction *= 10;
+        int64_t total = whole * 100 + fraction + (roundUp ? 1 : 0);
+        return Money(negative ? -total : total);
+    }
+
+    int64_t minorUnits() const { return cents; }
+    double toDouble() const { return cents / 100.0; }
+
+    // Plain decimal with two places, e.g. "1234.50"
+    string toString() const
+    {
+        char buffer[formatBufferSize];
+        return string(buffer, formatCents(buffer, buffer + sizeof(buffer), cents));
+    }
+
+    Money operator+(Money other) const { return Money(cents + other.cents); }
+    Money operator-(Money other) const { return Money(cents - other.cents); }
+    Money &operator+=(Money other)
+    {
+        cents += other.cents;
+        return *this;
+    }
+    Money &operator-=(Money other)
+    {
+        cents -= other.cents;
+        return *this;
+    }
+
+    bool operator==(Money other) const { return cents == other.cents; }
+    bool operator!=(Money other) const { return cents != other.cents; }
+    bool operator<(Money other) const { return cents < other.cents; }
+    bool operator>(Money other) const { return cents > other.cents; }
+};
+
+inline ostream &operator<<(ostream &out, Money amount)
+{
+    return out << amount.toString();
+}
+
+inline istream &operator>>(istream &in, Money &amount)
+{
+    string text;
+    if (in >> text)
+    {
+        try
+        {
+            amount = Money::parse(text);
+        }
+        catch (const std::exception &)
+        {
+            in.setstate(ios::failbit);
+        }
+    }
+    return in;
+}
+
+// Interns strings as small integer codes. Codes are handed out in order of
+// first appearance and never reused, so they stay valid for the lifetime of
+// the dictionary. Values live in a deque, so references to them stay valid
+// too. Thread-safe: the importer interns from several threads and the saver
+// reads values while the UI thread edits.
+class StringDictionary
+{
+private:
+    deque<string> values;
+    unordered_map<string, uint32_t> codes;
+    mutable mutex lock;
+
+public:
+    uint32_t intern(const string &value)
+    {
+        lock_guard<mutex> guard(lock);
+        auto it = codes.find(value);
+        if (it != codes.end())
+            return it->second;
+        uint32_t code = static_cast<uint32_t>(values.size());
+        values.push_back(value);
+        codes.emplace(value, code);
+        return code;
+    }
+
+    const string &value(uint32_t code) const
+    {
+        lock_guard<mutex> guard(lock);
+        return values[code];
+    }
+
+    // Looks a value up without interning it
+    bool find(const string &value, uint32_t &code) const
+    {
+        lock_guard<mutex> guard(lock);
+        auto it = codes.find(value);
+        if (it == codes.end())
+            return false;
+        code = it->second;
+        return true;
+    }
+
+    size_t size() const
+    {
+        lock_guard<mutex> guard(lock);
+        return values.size();
     }
 };
 
+// Employee fields whose values repeat across many rows
+enum InternedField
+{
+    FIELD_DEPARTMENT,
+    FIELD_POSITION,
+    FIELD_HIRING_STATUS
+};
+
+// A string field stored as a 4-byte code into the dictionary of its field.
+// Reads like a const string; equal values have equal codes, so group-bys can
+// index arrays by code() instead of hashing strings.
+template <InternedField Field>
+class Interned
+{
+private:
+    uint32_t id;
+
+public:
+    static StringDictionary &dictionary()
+    {
+        static StringDictionary values;
+        return values;
+    }
+
+    Interned(const string &value = "") : id(dictionary().intern(value)) {}
+
+    Interned &operator=(const string &value)
+    {
+        id = dictionary().intern(value);
+        return *this;
+    }
+
+    uint32_t code() const { return id; }
+    const string &str() const { return dictionary().value(id); }
+    operator const string &() const { return str(); }
+
+    bool operator==(const Interned &other) const { return id == other.id; }
+    bool operator!=(const Interned &other) const { return id != other.id; }
+    bool operator<(const Interned &other) const { return id != other.id && str() < other.str(); }
+};
+
+template <InternedField Field>
+ostream &operator<<(ostream &out, const Interned<Field> &value)
+{
+    return out << value.str();
+}
+
+using Department = Interned<FIELD_DEPARTMENT>;
+using Position = Interned<FIELD_POSITION>;
+using HiringStatus = Interned<FIELD_HIRING_STATUS>;
+
+// Codes with a non-zero count, ordered by their string value
+template <InternedField Field>
+vector<uint32_t> usedCodesByValue(const vector<int> &countByCode)
+{
+    vector<uint32_t> codes;
+    for (uint32_t code = 0; code < countByCode.size(); code++)
+    {
+        if (countByCode[code] > 0)
+            codes.push_back(code);
+    }
+    const StringDictionary &dict = Interned<Field>::dictionary();
+    sort(codes.begin(), codes.end(), [&](uint32_t a, uint32_t b)
+         { return dict.value(a) < dict.value(b); });
+    return codes;
+}
+
 // Employee Class (Core Data)
 class Employee
 {
 public:
     int id;
     string name;
-    string department;
-    string position;
-    double salary;
-    string hiringStatus;        // e.g., Applied, Hired, Active
-    map<Date, bool> attendance; // Date -> Present/Absent
+    Department department;
+    Position position;
+    Money salary;
+    HiringStatus hiringStatus;  // e.g., Applied, Hired, Active
+    AttendanceCalendar attendance; // Date -> Present/Absent
     double hoursWorked;
     double vacationDays;
     double sickDays;
@@ -65,7 +496,7 @@ public:
     int assignedClientId;  // To link with Client
     int assignedProjectId; // To link with Project
 
-    Employee(int id, const string &name, const string &department, const string &position, double salary)
+    Employee(int id, const string &name, const string &department, const string &position, Money salary)
         : id(id), name(name), department(department), position(position), salary(salary), hiringStatus("Applied"), hoursWorked(0), vacationDays(0), sickDays(0), otherLeaveDays(0), assignedClientId(-1), assignedProjectId(-1) {}
 
     void display() const
@@ -75,10 +506,10 @@ public:
         employee_details[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
         employee_details.add_row({"ID", to_string(id)});
         employee_details.add_row({"Name", name});
-        employee_details.add_row({"Department", department});
-        employee_details.add_row({"Position", position});
-        employee_details.add_row({"Salary", "$" + to_string_with_precision(salary)});
-        employee_details.add_row({"Hiring Status", hiringStatus});
+        employee_details.add_row({"Department", department.str()});
+        employee_details.add_row({"Position", position.str()});
+        employee_details.add_row({"Salary", "$" + salary.toString()});
+        employee_details.add_row({"Hiring Status", hiringStatus.str()});
         employee_details.add_row({"Hours Worked", to_string_with_precision(hoursWorked, 1)});
         employee_details.add_row({"Vacation Days", to_string(vacationDays)});
         employee_details.add_row({"Sick Days", to_string(sickDays)});
@@ -131,32 +562,2672 @@ public:
         client_details.add_row({"Contact Email", contactEmail});
         cout << client_details << endl;
     }
-};
+};
+
+// Project Class (Core Data)
+class Project
+{
+public:
+    int id;
+    string name;
+    string description;
+    Date deadline;
+    int clientId; // Link to a client
+
+    Project(int id, const string &name, const string &description, const Date &deadline, int clientId)
+        : id(id), name(name), description(description), deadline(deadline), clientId(clientId) {}
+
+    void display() const
+    {
+        Table project_details;
+        project_details.add_row({"Attribute", "Value"});
+        project_details[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
+        project_details.add_row({"Project ID", to_string(id)});
+        project_details.add_row({"Name", name});
+        project_details.add_row({"Description", description});
+        project_details.add_row({"Deadline", deadline.toString()});
+        project_details.add_row({"Client ID", to_string(clientId)});
+        cout << project_details << endl;
+    }
+};
+
+// --- INDEXES ---
+
+// Trigram inverted index over employee name, department and position.
+// Each field is folded to lower case and split into overlapping 3-byte
+// grams. A query only looks at employees that contain every gram of the
+// query; candidates are then checked with a real substring match, so the
+// results are exactly those of a full scan.
+class EmployeeSearchIndex
+{
+private:
+    unordered_map<uint32_t, unordered_set<int>> postings; // gram -> employee IDs
+    unordered_map<int, vector<uint32_t>> gramsById;       // What each employee is indexed under
+
+    static void collectGrams(const string &folded, vector<uint32_t> &grams)
+    {
+        for (size_t i = 0; i + 3 <= folded.size(); i++)
+        {
+            grams.push_back(uint32_t(uint8_t(folded[i])) << 16 |
+                            uint32_t(uint8_t(folded[i + 1])) << 8 |
+                            uint32_t(uint8_t(folded[i + 2])));
+        }
+    }
+
+public:
+    static constexpr size_t minQueryLength = 3;
+
+    // ASCII lower case; bytes of multi-byte UTF-8 sequences are kept as is
+    static string fold(const string &text)
+    {
+        string folded(text);
+        for (char &c : folded)
+        {
+            if (c >= 'A' && c <= 'Z')
+                c = static_cast<char>(c - 'A' + 'a');
+        }
+        return folded;
+    }
+
+    void add(const Employee &emp)
+    {
+        vector<uint32_t> grams;
+        collectGrams(fold(emp.name), grams);
+        collectGrams(fold(emp.department), grams);
+        collectGrams(fold(emp.position), grams);
+        sort(grams.begin(), grams.end());
+        grams.erase(unique(grams.begin(), grams.end()), grams.end());
+        for (uint32_t g : grams)
+            postings[g].insert(emp.id);
+        gramsById[emp.id] = move(grams);
+    }
+
+    void remove(int id)
+    {
+        auto it = gramsById.find(id);
+        if (it == gramsById.end())
+            return;
+        for (uint32_t g : it->second)
+        {
+            auto posting = postings.find(g);
+            if (posting == postings.end())
+                continue;
+            posting->second.erase(id);
+            if (posting->second.empty())
+                postings.erase(posting);
+        }
+        gramsById.erase(it);
+    }
+
+    void clear()
+    {
+        postings.clear();
+        gramsById.clear();
+    }
+
+    // IDs of employees whose indexed fields contain every gram of the query
+    // (in any case). The query must be at least minQueryLength bytes long.
+    vector<int> candidates(const string &query) const
+    {
+        vector<uint32_t> grams;
+        collectGrams(fold(query), grams);
+        sort(grams.begin(), grams.end());
+        grams.erase(unique(grams.begin(), grams.end()), grams.end());
+
+        vector<const unordered_set<int> *> lists;
+        for (uint32_t g : grams)
+        {
+            auto posting = postings.find(g);
+            if (posting == postings.end())
+                return {};
+            lists.push_back(&posting->second);
+        }
+        if (lists.empty())
+            return {};
+
+        // Walk the shortest posting list and probe the others
+        sort(lists.begin(), lists.end(), [](const unordered_set<int> *a, const unordered_set<int> *b)
+             { return a->size() < b->size(); });
+        vector<int> ids;
+        for (int id : *lists[0])
+        {
+            bool inAll = true;
+            for (size_t i = 1; i < lists.size() && inAll; i++)
+                inAll = lists[i]->count(id) > 0;
+            if (inAll)
+                ids.push_back(id);
+        }
+        return ids;
+    }
+};
+
+// Reverse index from a referenced ID (a client or project) to the IDs of the
+// rows that reference it. Each row's current key is remembered, so an update
+// only needs the row ID and its new key.
+class ReferenceIndex
+{
+private:
+    unordered_map<int, unordered_set<int>> rowsByKey;
+    unordered_map<int, int> keyByRow;
+
+public:
+    // A key of -1 means the row references nothing
+    void set(int rowId, int key)
+    {
+        auto it = keyByRow.find(rowId);
+        if (it != keyByRow.end())
+        {
+            if (it->second == key)
+                return;
+            remove(rowId);
+        }
+        if (key == -1)
+            return;
+        rowsByKey[key].insert(rowId);
+        keyByRow[rowId] = key;
+    }
+
+    void remove(int rowId)
+    {
+        auto it = keyByRow.find(rowId);
+        if (it == keyByRow.end())
+            return;
+        auto rows = rowsByKey.find(it->second);
+        rows->second.erase(rowId);
+        if (rows->second.empty())
+            rowsByKey.erase(rows);
+        keyByRow.erase(it);
+    }
+
+    void clear()
+    {
+        rowsByKey.clear();
+        keyByRow.clear();
+    }
+
+    const unordered_set<int> &rowsOf(int key) const
+    {
+        static const unordered_set<int> none;
+        auto it = rowsByKey.find(key);
+        return it == rowsByKey.end() ? none : it->second;
+    }
+};
+
+// Numeric employee fields stored column by column, in the same slot order
+// as the employees vector. Analytics loop over these contiguous arrays
+// instead of striding through whole Employee objects.
+struct EmployeeColumns
+{
+    vector<int32_t> id;
+    vector<int64_t> salaryCents;
+    vector<double> hoursWorked;
+    vector<double> vacationDays;
+    vector<double> sickDays;
+    vector<double> otherLeaveDays;
+    vector<uint32_t> department; // Department codes
+
+    size_t size() const { return id.size(); }
+
+    void append(const Employee &emp)
+    {
+        id.push_back(emp.id);
+        salaryCents.push_back(emp.salary.minorUnits());
+        hoursWorked.push_back(emp.hoursWorked);
+        vacationDays.push_back(emp.vacationDays);
+        sickDays.push_back(emp.sickDays);
+        otherLeaveDays.push_back(emp.otherLeaveDays);
+        department.push_back(emp.department.code());
+    }
+
+    void assign(size_t slot, const Employee &emp)
+    {
+        id[slot] = emp.id;
+        salaryCents[slot] = emp.salary.minorUnits();
+        hoursWorked[slot] = emp.hoursWorked;
+        vacationDays[slot] = emp.vacationDays;
+        sickDays[slot] = emp.sickDays;
+        otherLeaveDays[slot] = emp.otherLeaveDays;
+        department[slot] = emp.department.code();
+    }
+
+    // Drops the rows flagged in `dropped`, keeping the order of the rest
+    void compact(const vector<bool> &dropped)
+    {
+        auto keep = [&](auto &column)
+        {
+            size_t kept = 0;
+            for (size_t i = 0; i < column.size(); i++)
+            {
+                if (!dropped[i])
+                    column[kept++] = column[i];
+            }
+            column.resize(kept);
+        };
+        keep(id);
+        keep(salaryCents);
+        keep(hoursWorked);
+        keep(vacationDays);
+        keep(sickDays);
+        keep(otherLeaveDays);
+        keep(department);
+    }
+
+    void clear()
+    {
+        id.clear();
+        salaryCents.clear();
+        hoursWorked.clear();
+        vacationDays.clear();
+        sickDays.clear();
+        otherLeaveDays.clear();
+        department.clear();
+    }
+
+    void reserve(size_t rows)
+    {
+        id.reserve(rows);
+        salaryCents.reserve(rows);
+        hoursWorked.reserve(rows);
+        vacationDays.reserve(rows);
+        sickDays.reserve(rows);
+        otherLeaveDays.reserve(rows);
+        department.reserve(rows);
+    }
+};
+
+
+// Date-major copy of everyone's attendance: for each date, one bitmap of
+// employees with a record that day and one of those present. Bits are
+// indexed by employee ID, which unlike the vector slot survives sorts and
+// deletes. Who was absent on a day is `recorded & ~present` over one row.
+class AttendanceByDate
+{
+private:
+    struct DayBits
+    {
+        vector<uint64_t> recorded;
+        vector<uint64_t> present;
+    };
+
+    map<Date, DayBits> days;
+
+    static size_t popcount(const vector<uint64_t> &words)
+    {
+        size_t total = 0;
+        for (uint64_t w : words)
+            total += bitset<64>(w).count();
+        return total;
+    }
+
+public:
+    struct DayCount
+    {
+        Date date;
+        size_t present;
+        size_t absent;
+    };
+
+    void set(int empId, const Date &date, bool isPresent)
+    {
+        if (empId < 0)
+            return;
+        DayBits &bits = days[date];
+        size_t word = static_cast<size_t>(empId) / 64;
+        if (bits.recorded.size() <= word)
+        {
+            bits.recorded.resize(word + 1, 0);
+            bits.present.resize(word + 1, 0);
+        }
+        uint64_t bit = uint64_t(1) << (empId % 64);
+        bits.recorded[word] |= bit;
+        if (isPresent)
+            bits.present[word] |= bit;
+        else
+            bits.present[word] &= ~bit;
+    }
+
+    void addEmployee(const Employee &emp)
+    {
+        emp.attendance.forEach([&](const Date &date, bool isPresent)
+                               { set(emp.id, date, isPresent); });
+    }
+
+    // Clears the employee's bit on the days they have a record for. Days
+    // left with no records stay until pruneEmptyDays().
+    void removeEmployee(const Employee &emp)
+    {
+        if (emp.id < 0)
+            return;
+        size_t word = static_cast<size_t>(emp.id) / 64;
+        uint64_t bit = uint64_t(1) << (emp.id % 64);
+        emp.attendance.forEach([&](const Date &date, bool)
+                               {
+            auto it = days.find(date);
+            if (it == days.end() || word >= it->second.recorded.size())
+                return;
+            it->second.recorded[word] &= ~bit;
+            it->second.present[word] &= ~bit; });
+    }
+
+    void pruneEmptyDays()
+    {
+        for (auto it = days.begin(); it != days.end();)
+        {
+            if (popcount(it->second.recorded) == 0)
+                it = days.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    void clear() { days.clear(); }
+
+    // Present and absent headcounts for every recorded day in [from, to]
+    vector<DayCount> headcounts(const Date &from, const Date &to) const
+    {
+        vector<DayCount> counts;
+        for (auto it = days.lower_bound(from); it != days.end() && !(to < it->first); ++it)
+        {
+            size_t recorded = popcount(it->second.recorded);
+            if (recorded == 0)
+                continue; // Everyone recorded that day was removed
+            size_t present = popcount(it->second.present);
+            counts.push_back({it->first, present, recorded - present});
+        }
+        return counts;
+    }
+
+    // (employee ID, days absent) for everyone absent at least once in
+    // [from, to], by ID
+    vector<pair<int, int>> absences(const Date &from, const Date &to) const
+    {
+        vector<int> daysAbsent;
+        for (auto it = days.lower_bound(from); it != days.end() && !(to < it->first); ++it)
+        {
+            const DayBits &bits = it->second;
+            if (daysAbsent.size() < bits.recorded.size() * 64)
+                daysAbsent.resize(bits.recorded.size() * 64, 0);
+            for (size_t w = 0; w < bits.recorded.size(); w++)
+            {
+                uint64_t absent = bits.recorded[w] & ~bits.present[w];
+                while (absent)
+                {
+                    size_t bit = bitset<64>((absent & (~absent + 1)) - 1).count(); // Lowest set bit
+                    absent &= absent - 1;
+                    daysAbsent[w * 64 + bit]++;
+                }
+            }
+        }
+        vector<pair<int, int>> result;
+        for (size_t id = 0; id < daysAbsent.size(); id++)
+        {
+            if (daysAbsent[id] > 0)
+                result.push_back({static_cast<int>(id), daysAbsent[id]});
+        }
+        return result;
+    }
+};
+
+// Running per-department totals, indexed by department code. Each
+// employee's last contribution is remembered, so an edit only subtracts
+// the old values and adds the new ones; reports read the totals directly.
+class DepartmentAggregates
+{
+public:
+    struct Totals
+    {
+        int count = 0;
+        Money salarySum;
+        double hoursSum = 0;
+        multiset<Money> salaries; // For min/max as employees come and go
+    };
+
+private:
+    struct Contribution
+    {
+        uint32_t department;
+        Money salary;
+        double hours;
+    };
+
+    vector<Totals> byCode;
+    unordered_map<int, Contribution> contributionById;
+
+public:
+    void set(const Employee &emp)
+    {
+        remove(emp.id);
+        Contribution c{emp.department.code(), emp.salary, emp.hoursWorked};
+        if (byCode.size() <= c.department)
+            byCode.resize(c.department + 1);
+        Totals &totals = byCode[c.department];
+        totals.count++;
+        totals.salarySum += c.salary;
+        totals.hoursSum += c.hours;
+        totals.salaries.insert(c.salary);
+        contributionById[emp.id] = c;
+    }
+
+    void remove(int id)
+    {
+        auto it = contributionById.find(id);
+        if (it == contributionById.end())
+            return;
+        const Contribution &c = it->second;
+        Totals &totals = byCode[c.department];
+        totals.count--;
+        totals.salarySum -= c.salary;
+        totals.hoursSum -= c.hours;
+        totals.salaries.erase(totals.salaries.find(c.salary));
+        if (totals.count == 0)
+            totals = Totals(); // Drop accumulated rounding error
+        contributionById.erase(it);
+    }
+
+    void clear()
+    {
+        byCode.clear();
+        contributionById.clear();
+    }
+
+    // Totals of a department code; count is 0 for departments nobody is in
+    const Totals &of(uint32_t code) const
+    {
+        static const Totals none;
+        return code < byCode.size() ? byCode[code] : none;
+    }
+
+    // Employee count per department code
+    vector<int> counts() const
+    {
+        vector<int> result(byCode.size());
+        for (size_t code = 0; code < byCode.size(); code++)
+            result[code] = byCode[code].count;
+        return result;
+    }
+};
+
+// Runs fn(begin, end) over [0, n) split into one chunk per hardware
+// thread. Small inputs run on the calling thread.
+template <typename Fn>
+void parallelFor(size_t n, Fn fn, size_t minChunk = 4096)
+{
+    size_t threads = max<size_t>(1, thread::hardware_concurrency());
+    size_t chunks = min(threads, max<size_t>(1, n / minChunk));
+    if (chunks <= 1)
+    {
+        fn(size_t(0), n);
+        return;
+    }
+    vector<future<void>> tasks;
+    size_t step = (n + chunks - 1) / chunks;
+    for (size_t begin = 0; begin < n; begin += step)
+    {
+        tasks.push_back(async(launch::async, [&fn, begin, step, n]
+                              { fn(begin, min(n, begin + step)); }));
+    }
+    for (auto &task : tasks)
+        task.get();
+}
+
+// Sum of an integer column. Integer addition is associative, so the plain
+// loop vectorizes and the per-thread partial sums add up to the same exact
+// total however the work is split.
+inline int64_t columnSum(const vector<int64_t> &column)
+{
+    size_t threads = max<size_t>(1, thread::hardware_concurrency());
+    vector<int64_t> partials(threads, 0);
+    size_t step = (column.size() + threads - 1) / threads;
+    parallelFor(threads, [&](size_t first, size_t last)
+                {
+        for (size_t t = first; t < last; t++)
+        {
+            int64_t sum = 0;
+            const int64_t *values = column.data();
+            for (size_t i = t * step, end = min(column.size(), (t + 1) * step); i < end; i++)
+                sum += values[i];
+            partials[t] = sum;
+        } }, column.size() < 65536 ? threads : 1);
+    return accumulate(partials.begin(), partials.end(), int64_t(0));
+}
+
+// Sorts by sorting one chunk per hardware thread and then merging
+// neighbouring runs pairwise, each round of merges in parallel
+template <typename T>
+void parallelSort(vector<T> &values)
+{
+    size_t threads = max<size_t>(1, thread::hardware_concurrency());
+    size_t chunks = min(threads, max<size_t>(1, values.size() / 16384));
+    if (chunks <= 1)
+    {
+        sort(values.begin(), values.end());
+        return;
+    }
+    size_t run = (values.size() + chunks - 1) / chunks;
+    parallelFor(chunks, [&](size_t first, size_t last)
+                {
+        for (size_t c = first; c < last; c++)
+            sort(values.begin() + min(values.size(), c * run), values.begin() + min(values.size(), (c + 1) * run)); }, 1);
+    for (; run < values.size(); run *= 2)
+    {
+        size_t pairs = (values.size() + 2 * run - 1) / (2 * run);
+        parallelFor(pairs, [&](size_t first, size_t last)
+                    {
+            for (size_t p = first; p < last; p++)
+            {
+                size_t begin = p * 2 * run, middle = min(values.size(), begin + run), end = min(values.size(), begin + 2 * run);
+                inplace_merge(values.begin() + begin, values.begin() + middle, values.begin() + end);
+            } }, 1);
+    }
+}
+
+// Percentile (0-100) of sorted values, interpolating between the closest ranks
+template <typename T>
+double percentile(const vector<T> &sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    double rank = p / 100.0 * (sorted.size() - 1);
+    size_t below = static_cast<size_t>(rank);
+    if (below + 1 >= sorted.size())
+        return double(sorted.back());
+    return sorted[below] + (rank - below) * (double(sorted[below + 1]) - double(sorted[below]));
+}
+
+// Indexes over the shared employees vector. Maps employee IDs to their slot
+// so lookups by ID are O(1), and maintains the text search index, the
+// project -> employees and client -> employees reverse indexes, the
+// columnar copy of the numeric fields, the date-major attendance and the
+// per-department totals. One
+// instance is shared by every feature class; code that adds, removes,
+// reorders or edits employees reports it here.
+//
+// Deleting an employee only tombstones its slot: the record stays in the
+// vector until compact() drops all dead slots in one pass, so deletes do
+// not shift the roster. Code that walks the vector by slot skips the
+// slots isLive() rejects; lookups through the index never return them.
+class EmployeeIndex
+{
+private:
+    vector<Employee> &employees;
+    unordered_map<int, size_t> slotById;
+    vector<bool> dead; // Tombstoned slots, parallel to the vector
+    size_t deadCount = 0;
+    EmployeeSearchIndex textIndex;
+    ReferenceIndex byProject;
+    ReferenceIndex byClient;
+    ReferenceIndex byDepartment; // Keyed by department code
+    EmployeeColumns columnStore;
+    AttendanceByDate attendanceByDate;
+    DepartmentAggregates departmentTotals;
+
+    void indexFields(const Employee &emp)
+    {
+        textIndex.add(emp);
+        byProject.set(emp.id, emp.assignedProjectId);
+        byClient.set(emp.id, emp.assignedClientId);
+        byDepartment.set(emp.id, static_cast<int>(emp.department.code()));
+        departmentTotals.set(emp);
+    }
+
+public:
+    EmployeeIndex(vector<Employee> &allEmployees) : employees(allEmployees) {}
+
+    Employee *find(int id)
+    {
+        auto it = slotById.find(id);
+        return it == slotById.end() ? nullptr : &employees[it->second];
+    }
+
+    const Employee *find(int id) const
+    {
+        auto it = slotById.find(id);
+        return it == slotById.end() ? nullptr : &employees[it->second];
+    }
+
+    // Slot of the employee in the vector, or -1 if there is none
+    long slotOf(int id) const
+    {
+        auto it = slotById.find(id);
+        return it == slotById.end() ? -1 : static_cast<long>(it->second);
+    }
+
+    bool isLive(size_t slot) const { return !dead[slot]; }
+    size_t liveCount() const { return employees.size() - deadCount; }
+    size_t tombstones() const { return deadCount; }
+
+    // Live slots in roster order
+    vector<uint32_t> liveSlots() const
+    {
+        vector<uint32_t> slots;
+        slots.reserve(liveCount());
+        for (size_t i = 0; i < employees.size(); i++)
+        {
+            if (!dead[i])
+                slots.push_back(static_cast<uint32_t>(i));
+        }
+        return slots;
+    }
+
+    const EmployeeSearchIndex &text() const { return textIndex; }
+    // Rows are slot-aligned and include tombstoned slots
+    const EmployeeColumns &columns() const { return columnStore; }
+    const AttendanceByDate &attendance() const { return attendanceByDate; }
+    const DepartmentAggregates &departments() const { return departmentTotals; }
+
+    // IDs of the employees assigned to a project / client
+    const unordered_set<int> &onProject(int projectId) const { return byProject.rowsOf(projectId); }
+    const unordered_set<int> &onClient(int clientId) const { return byClient.rowsOf(clientId); }
+    const unordered_set<int> &inDepartment(uint32_t code) const { return byDepartment.rowsOf(static_cast<int>(code)); }
+
+    // Slots of the given employees in roster order
+    vector<size_t> slotsOf(const unordered_set<int> &ids) const
+    {
+        vector<size_t> slots;
+        slots.reserve(ids.size());
+        for (int id : ids)
+        {
+            auto it = slotById.find(id);
+            if (it != slotById.end())
+                slots.push_back(it->second);
+        }
+        sort(slots.begin(), slots.end());
+        return slots;
+    }
+
+    // Call after appending an employee to the vector
+    void added()
+    {
+        slotById[employees.back().id] = employees.size() - 1;
+        dead.push_back(false);
+        indexFields(employees.back());
+        columnStore.append(employees.back());
+        attendanceByDate.addEmployee(employees.back());
+    }
+
+    // Call after recording a day of attendance for an employee
+    void attendanceRecorded(const Employee &emp, const Date &date, bool present)
+    {
+        attendanceByDate.set(emp.id, date, present);
+    }
+
+    // Call after changing any field of an employee
+    void changed(const Employee &emp)
+    {
+        textIndex.remove(emp.id);
+        indexFields(emp);
+        auto it = slotById.find(emp.id);
+        if (it != slotById.end())
+            columnStore.assign(it->second, emp);
+    }
+
+    // Deletes an employee by tombstoning its slot. Returns false if there
+    // is no such employee.
+    bool remove(int id)
+    {
+        auto it = slotById.find(id);
+        if (it == slotById.end())
+            return false;
+        attendanceByDate.removeEmployee(employees[it->second]);
+        dead[it->second] = true;
+        deadCount++;
+        slotById.erase(it);
+        textIndex.remove(id);
+        byProject.remove(id);
+        byClient.remove(id);
+        byDepartment.remove(id);
+        departmentTotals.remove(id);
+        return true;
+    }
+
+    // Erases the tombstoned employees from the vector in one pass, keeping
+    // roster order, and re-slots the slot-keyed indexes
+    void compact()
+    {
+        if (deadCount == 0)
+            return;
+        size_t kept = 0;
+        for (size_t i = 0; i < employees.size(); i++)
+        {
+            if (dead[i])
+                continue;
+            if (kept != i)
+            {
+                employees[kept] = move(employees[i]);
+                slotById[employees[kept].id] = kept;
+            }
+            kept++;
+        }
+        employees.erase(employees.begin() + kept, employees.end());
+        columnStore.compact(dead);
+        attendanceByDate.pruneEmptyDays();
+        dead.assign(kept, false);
+        deadCount = 0;
+    }
+
+    // Compacts once tombstones make up a quarter of the slots, so a run of
+    // deletes costs amortized O(1) each
+    void compactIfSparse()
+    {
+        if (deadCount * 4 > employees.size())
+            compact();
+    }
+
+    // Call after the vector was reloaded or reordered. Reordering must
+    // compact() first, as rebuilding revives tombstoned slots.
+    void rebuild()
+    {
+        slotById.clear();
+        slotById.reserve(employees.size());
+        dead.assign(employees.size(), false);
+        deadCount = 0;
+        textIndex.clear();
+        byProject.clear();
+        byClient.clear();
+        byDepartment.clear();
+        columnStore.clear();
+        columnStore.reserve(employees.size());
+        attendanceByDate.clear();
+        departmentTotals.clear();
+        for (size_t i = 0; i < employees.size(); i++)
+        {
+            slotById[employees[i].id] = i;
+            indexFields(employees[i]);
+            columnStore.append(employees[i]);
+            attendanceByDate.addEmployee(employees[i]);
+        }
+    }
+
+    // Unassigns every employee from a deleted project and returns them
+    vector<Employee *> unassignProject(int projectId)
+    {
+        vector<Employee *> reset;
+        for (size_t slot : slotsOf(onProject(projectId)))
+        {
+            Employee &emp = employees[slot];
+            emp.assignedProjectId = -1;
+            changed(emp);
+            reset.push_back(&emp);
+        }
+        return reset;
+    }
+};
+
+// ID -> slot index over the shared projects vector, plus the
+// client -> projects reverse index. Shared like EmployeeIndex, and deletes
+// tombstone slots the same way.
+class ProjectIndex
+{
+private:
+    vector<Project> &projects;
+    unordered_map<int, size_t> slotById;
+    ReferenceIndex byClient;
+    vector<bool> dead; // Tombstoned slots, parallel to the vector
+    size_t deadCount = 0;
+
+public:
+    ProjectIndex(vector<Project> &allProjects) : projects(allProjects) {}
+
+    Project *find(int id)
+    {
+        auto it = slotById.find(id);
+        return it == slotById.end() ? nullptr : &projects[it->second];
+    }
+
+    // Slot of the project in the vector, or -1 if there is none
+    long slotOf(int id) const
+    {
+        auto it = slotById.find(id);
+        return it == slotById.end() ? -1 : static_cast<long>(it->second);
+    }
+
+    bool isLive(size_t slot) const { return !dead[slot]; }
+    size_t liveCount() const { return projects.size() - deadCount; }
+
+    // Slots of the client's projects in vector order
+    vector<size_t> forClient(int clientId) const
+    {
+        vector<size_t> slots;
+        for (int id : byClient.rowsOf(clientId))
+            slots.push_back(slotById.at(id));
+        sort(slots.begin(), slots.end());
+        return slots;
+    }
+
+    // Call after appending a project to the vector
+    void added()
+    {
+        slotById[projects.back().id] = projects.size() - 1;
+        dead.push_back(false);
+        byClient.set(projects.back().id, projects.back().clientId);
+    }
+
+    // Call after changing a project
+    void changed(const Project &proj)
+    {
+        byClient.set(proj.id, proj.clientId);
+    }
+
+    // Deletes a project by tombstoning its slot. Returns false if there is
+    // no such project.
+    bool remove(int id)
+    {
+        auto it = slotById.find(id);
+        if (it == slotById.end())
+            return false;
+        dead[it->second] = true;
+        deadCount++;
+        slotById.erase(it);
+        byClient.remove(id);
+        return true;
+    }
+
+    // Erases the tombstoned projects from the vector in one pass
+    void compact()
+    {
+        if (deadCount == 0)
+            return;
+        size_t kept = 0;
+        for (size_t i = 0; i < projects.size(); i++)
+        {
+            if (dead[i])
+                continue;
+            if (kept != i)
+            {
+                projects[kept] = move(projects[i]);
+                slotById[projects[kept].id] = kept;
+            }
+            kept++;
+        }
+        projects.erase(projects.begin() + kept, projects.end());
+        dead.assign(kept, false);
+        deadCount = 0;
+    }
+
+    void compactIfSparse()
+    {
+        if (deadCount * 4 > projects.size())
+            compact();
+    }
+
+    // Call after the vector was reloaded
+    void rebuild()
+    {
+        slotById.clear();
+        slotById.reserve(projects.size());
+        dead.assign(projects.size(), false);
+        deadCount = 0;
+        byClient.clear();
+        for (size_t i = 0; i < projects.size(); i++)
+        {
+            slotById[projects[i].id] = i;
+            byClient.set(projects[i].id, projects[i].clientId);
+        }
+    }
+};
+
+// Employee filter such as `department=Sales and salary>4000 and project=12`.
+// The query is parsed once into a list of compiled predicates. Running it
+// starts from the smallest candidate set an index can give for one of the
+// equality clauses (ID, department, project or client) and falls back to
+// scanning the roster when there is none.
+//
+// Clauses are joined with `and`. Fields: id, name, department, position,
+// status, salary, hours, vacation, sick, other, client, project.
+// Operators: = != < <= > >= and ~ (contains, ignoring case) for text.
+// Values containing spaces go in double quotes; client/project accept `none`.
+class EmployeeFilter
+{
+private:
+    struct Predicate
+    {
+        string field;
+        string op;
+        string value;
+        function<bool(const Employee &)> test;
+    };
+
+    vector<Predicate> predicates;
+
+    static vector<string> tokenize(const string &query)
+    {
+        vector<string> tokens;
+        size_t i = 0;
+        while (i < query.size())
+        {
+            char c = query[i];
+            if (isspace(static_cast<unsigned char>(c)))
+            {
+                i++;
+            }
+            else if (c == '"')
+            {
+                size_t end = query.find('"', i + 1);
+                if (end == string::npos)
+                    throw invalid_argument("missing closing quote");
+                tokens.push_back(query.substr(i, end - i + 1)); // Keeps the quotes to mark a literal
+                i = end + 1;
+            }
+            else if (strchr("=!<>~", c))
+            {
+                size_t len = (i + 1 < query.size() && query[i + 1] == '=' && c != '=' && c != '~') ? 2 : 1;
+                tokens.push_back(query.substr(i, len));
+                i += len;
+            }
+            else
+            {
+                size_t start = i;
+                while (i < query.size() && !isspace(static_cast<unsigned char>(query[i])) && !strchr("=!<>~\"", query[i]))
+                    i++;
+                tokens.push_back(query.substr(start, i - start));
+            }
+        }
+        return tokens;
+    }
+
+    static bool isOperator(const string &token)
+    {
+        return token == "=" || token == "!=" || token == "<" || token == "<=" || token == ">" || token == ">=" || token == "~";
+    }
+
+    // Builds the test for `field op value` on a number read by `get`
+    template <typename T, typename Get>
+    static function<bool(const Employee &)> numberTest(const string &op, Get get, T value)
+    {
+        if (op == "=")
+            return [=](const Employee &e)
+            { return get(e) == value; };
+        if (op == "!=")
+            return [=](const Employee &e)
+            { return get(e) != value; };
+        if (op == "<")
+            return [=](const Employee &e)
+            { return get(e) < value; };
+        if (op == "<=")
+            return [=](const Employee &e)
+            { return !(value < get(e)); };
+        if (op == ">")
+            return [=](const Employee &e)
+            { return value < get(e); };
+        if (op == ">=")
+            return [=](const Employee &e)
+            { return !(get(e) < value); };
+        throw invalid_argument("operator " + op + " does not apply to numbers");
+    }
+
+    // Builds the test for an interned text field; equality compares codes
+    template <InternedField Field, typename Get>
+    static function<bool(const Employee &)> internedTest(const string &op, Get get, const string &value)
+    {
+        if (op == "~")
+        {
+            string needle = EmployeeSearchIndex::fold(value);
+            return [=](const Employee &e)
+            { return EmployeeSearchIndex::fold(get(e).str()).find(needle) != string::npos; };
+        }
+        if (op != "=" && op != "!=")
+            throw invalid_argument("operator " + op + " does not apply to text");
+        uint32_t code = 0;
+        bool known = Interned<Field>::dictionary().find(value, code);
+        bool equal = (op == "=");
+        return [=](const Employee &e)
+        { return (known && get(e).code() == code) == equal; };
+    }
+
+    static int parseId(const string &value)
+    {
+        if (value == "none")
+            return -1;
+        size_t used;
+        int id = stoi(value, &used);
+        if (used != value.size())
+            throw invalid_argument("not a number: " + value);
+        return id;
+    }
+
+    static double parseNumber(const string &value)
+    {
+        size_t used;
+        double number = stod(value, &used);
+        if (used != value.size())
+            throw invalid_argument("not a number: " + value);
+        return number;
+    }
+
+    static function<bool(const Employee &)> compile(const string &field, const string &op, const string &value)
+    {
+        if (field == "id")
+            return numberTest(op, [](const Employee &e)
+                              { return e.id; }, parseId(value));
+        if (field == "client")
+            return numberTest(op, [](const Employee &e)
+                              { return e.assignedClientId; }, parseId(value));
+        if (field == "project")
+            return numberTest(op, [](const Employee &e)
+                              { return e.assignedProjectId; }, parseId(value));
+        if (field == "salary")
+            return numberTest(op, [](const Employee &e)
+                              { return e.salary; }, Money::parse(value));
+        if (field == "hours")
+            return numberTest(op, [](const Employee &e)
+                              { return e.hoursWorked; }, parseNumber(value));
+        if (field == "vacation")
+            return numberTest(op, [](const Employee &e)
+                              { return e.vacationDays; }, parseNumber(value));
+        if (field == "sick")
+            return numberTest(op, [](const Employee &e)
+                              { return e.sickDays; }, parseNumber(value));
+        if (field == "other")
+            return numberTest(op, [](const Employee &e)
+                              { return e.otherLeaveDays; }, parseNumber(value));
+        if (field == "department")
+            return internedTest<FIELD_DEPARTMENT>(op, [](const Employee &e) -> const Department &
+                                                  { return e.department; }, value);
+        if (field == "position")
+            return internedTest<FIELD_POSITION>(op, [](const Employee &e) -> const Position &
+                                                { return e.position; }, value);
+        if (field == "status")
+            return internedTest<FIELD_HIRING_STATUS>(op, [](const Employee &e) -> const HiringStatus &
+                                                     { return e.hiringStatus; }, value);
+        if (field == "name")
+        {
+            if (op == "~")
+            {
+                string needle = EmployeeSearchIndex::fold(value);
+                return [=](const Employee &e)
+                { return EmployeeSearchIndex::fold(e.name).find(needle) != string::npos; };
+            }
+            if (op == "=" || op == "!=")
+            {
+                bool equal = (op == "=");
+                return [=](const Employee &e)
+                { return (e.name == value) == equal; };
+            }
+            throw invalid_argument("operator " + op + " does not apply to text");
+        }
+        throw invalid_argument("unknown field: " + field);
+    }
+
+public:
+    // Throws invalid_argument describing the first problem in the query
+    static EmployeeFilter parse(const string &query)
+    {
+        EmployeeFilter filter;
+        vector<string> tokens = tokenize(query);
+        if (tokens.empty())
+            throw invalid_argument("empty query");
+        size_t i = 0;
+        while (true)
+        {
+            if (i + 3 > tokens.size())
+                throw invalid_argument("expected `field operator value`");
+            string field = EmployeeSearchIndex::fold(tokens[i]);
+            if (field == "dept")
+                field = "department";
+            const string &op = tokens[i + 1];
+            string value = tokens[i + 2];
+            if (!isOperator(op))
+                throw invalid_argument("expected an operator after " + tokens[i]);
+            if (isOperator(value))
+                throw invalid_argument("expected a value after " + op);
+            if (value.size() >= 2 && value.front() == '"')
+                value = value.substr(1, value.size() - 2);
+            try
+            {
+                filter.predicates.push_back({field, op, value, compile(field, op, value)});
+            }
+            catch (const out_of_range &)
+            {
+                throw invalid_argument("number out of range: " + value);
+            }
+            i += 3;
+            if (i == tokens.size())
+                break;
+            if (EmployeeSearchIndex::fold(tokens[i]) != "and")
+                throw invalid_argument("expected `and` before " + tokens[i]);
+            i++;
+        }
+        return filter;
+    }
+
+    // Matching employees in roster order. `plan` receives a short
+    // description of how the candidates were found.
+    vector<const Employee *> run(const vector<Employee> &employees, const EmployeeIndex &index, string &plan) const
+    {
+        // Pick the equality clause whose index gives the fewest candidates
+        const unordered_set<int> *best = nullptr;
+        unordered_set<int> idCandidate;
+        for (const Predicate &p : predicates)
+        {
+            if (p.op != "=")
+                continue;
+            const unordered_set<int> *candidates = nullptr;
+            string source;
+            if (p.field == "id")
+            {
+                idCandidate.clear();
+                if (index.find(parseId(p.value)))
+                    idCandidate.insert(parseId(p.value));
+                candidates = &idCandidate;
+                source = "ID index";
+            }
+            else if (p.field == "department")
+            {
+                uint32_t code = 0;
+                static const unordered_set<int> none;
+                candidates = Department::dictionary().find(p.value, code) ? &index.inDepartment(code) : &none;
+                source = "department index";
+            }
+            else if ((p.field == "project" || p.field == "client") && p.value != "none")
+            {
+                int id = parseId(p.value);
+                candidates = (p.field == "project") ? &index.onProject(id) : &index.onClient(id);
+                source = p.field + " index";
+            }
+            if (candidates && (!best || candidates->size() < best->size()))
+            {
+                best = candidates;
+                plan = source + ", " + to_string(candidates->size()) + " candidate(s)";
+            }
+        }
+
+        vector<const Employee *> matches;
+        auto accept = [&](const Employee &emp)
+        {
+            for (const Predicate &p : predicates)
+            {
+                if (!p.test(emp))
+                    return;
+            }
+            matches.push_back(&emp);
+        };
+        if (best)
+        {
+            for (size_t slot : index.slotsOf(*best))
+                accept(employees[slot]);
+        }
+        else
+        {
+            plan = "full scan, " + to_string(index.liveCount()) + " employee(s)";
+            for (uint32_t slot : index.liveSlots())
+                accept(employees[slot]);
+        }
+        return matches;
+    }
+};
+
+// Sorted view of the roster: a permutation of slots that leaves the
+// employees vector, and so the persisted order, untouched. Keys are applied
+// from last to first with a stable sort each, so earlier keys take
+// precedence. Numeric and interned keys are radix sorted as 64-bit keys;
+// only names need a comparison sort.
+class EmployeeOrder
+{
+public:
+    struct Key
+    {
+        string field;
+        bool descending;
+    };
+
+    // Parses "department, -salary" or "department asc, salary desc".
+    // Throws invalid_argument for unknown fields.
+    static vector<Key> parse(const string &spec)
+    {
+        static const unordered_set<string> fields = {"id", "name", "department", "position", "status", "salary", "hours"};
+        vector<Key> keys;
+        stringstream in(spec);
+        string part;
+        while (getline(in, part, ','))
+        {
+            stringstream words(part);
+            string field, direction, extra;
+            words >> field >> direction >> extra;
+            if (field.empty())
+                continue;
+            bool descending = false;
+            if (field[0] == '-')
+            {
+                descending = true;
+                field = field.substr(1);
+            }
+            field = EmployeeSearchIndex::fold(field);
+            direction = EmployeeSearchIndex::fold(direction);
+            if (direction == "desc")
+                descending = true;
+            else if (!direction.empty() && direction != "asc")
+                throw invalid_argument("expected asc or desc after " + field);
+            if (!extra.empty() || !fields.count(field))
+                throw invalid_argument("cannot sort by " + part);
+            keys.push_back({field, descending});
+        }
+        if (keys.empty())
+            throw invalid_argument("no sort keys given");
+        return keys;
+    }
+
+    // Live slots of `employees` in the requested order
+    static vector<uint32_t> sort(const vector<Employee> &employees, const EmployeeIndex &index, const vector<Key> &keys)
+    {
+        vector<uint32_t> order = index.liveSlots();
+        const EmployeeColumns &cols = index.columns();
+        vector<uint64_t> keyBySlot(employees.size());
+        for (auto key = keys.rbegin(); key != keys.rend(); ++key)
+        {
+            if (key->field == "name")
+            {
+                if (key->descending)
+                    stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+                                { return employees[b].name < employees[a].name; });
+                else
+                    stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+                                { return employees[a].name < employees[b].name; });
+                continue;
+            }
+
+            if (key->field == "id")
+            {
+                for (size_t i = 0; i < cols.size(); i++)
+                    keyBySlot[i] = orderedBits(int64_t(cols.id[i]));
+            }
+            else if (key->field == "salary")
+            {
+                for (size_t i = 0; i < cols.size(); i++)
+                    keyBySlot[i] = orderedBits(cols.salaryCents[i]);
+            }
+            else if (key->field == "hours")
+            {
+                for (size_t i = 0; i < cols.size(); i++)
+                    keyBySlot[i] = orderedBits(cols.hoursWorked[i]);
+            }
+            else if (key->field == "department")
+            {
+                vector<uint64_t> rank = rankByCode<FIELD_DEPARTMENT>();
+                for (size_t i = 0; i < cols.size(); i++)
+                    keyBySlot[i] = rank[cols.department[i]];
+            }
+            else if (key->field == "position")
+            {
+                vector<uint64_t> rank = rankByCode<FIELD_POSITION>();
+                for (size_t i = 0; i < employees.size(); i++)
+                    keyBySlot[i] = rank[employees[i].position.code()];
+            }
+            else // status
+            {
+                vector<uint64_t> rank = rankByCode<FIELD_HIRING_STATUS>();
+                for (size_t i = 0; i < employees.size(); i++)
+                    keyBySlot[i] = rank[employees[i].hiringStatus.code()];
+            }
+            if (key->descending)
+            {
+                for (uint64_t &k : keyBySlot)
+                    k = ~k;
+            }
+            radixSort(order, keyBySlot);
+        }
+        return order;
+    }
+
+private:
+    // Maps values to unsigned keys with the same ordering
+    static uint64_t orderedBits(int64_t value) { return uint64_t(value) ^ (uint64_t(1) << 63); }
+    static uint64_t orderedBits(double value)
+    {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+    }
+
+    // Position of each code when the dictionary values are sorted
+    template <InternedField Field>
+    static vector<uint64_t> rankByCode()
+    {
+        const StringDictionary &dict = Interned<Field>::dictionary();
+        vector<uint32_t> codes(dict.size());
+        iota(codes.begin(), codes.end(), 0);
+        std::sort(codes.begin(), codes.end(), [&](uint32_t a, uint32_t b)
+                  { return dict.value(a) < dict.value(b); });
+        vector<uint64_t> rank(codes.size());
+        for (size_t r = 0; r < codes.size(); r++)
+            rank[codes[r]] = r;
+        return rank;
+    }
+
+    // Stable LSD radix sort of `order` by keyBySlot[slot], one byte per
+    // pass; passes where every key has the same byte are skipped
+    static void radixSort(vector<uint32_t> &order, const vector<uint64_t> &keyBySlot)
+    {
+        vector<uint32_t> buffer(order.size());
+        for (int shift = 0; shift < 64; shift += 8)
+        {
+            size_t counts[257] = {0};
+            for (uint32_t slot : order)
+                counts[((keyBySlot[slot] >> shift) & 0xFF) + 1]++;
+            if (*max_element(counts + 1, counts + 257) == order.size())
+                continue;
+            for (int b = 0; b < 256; b++)
+                counts[b + 1] += counts[b];
+            for (uint32_t slot : order)
+                buffer[counts[(keyBySlot[slot] >> shift) & 0xFF]++] = slot;
+            order.swap(buffer);
+        }
+    }
+};
+
+// Result sets with more rows than this skip tabulate for TextTable
+constexpr size_t streamingTableThreshold = 200;
+
+// Standard report look: bold yellow header row
+void styleHeaderRow(Table &table)
+{
+    table[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
+}
+
+// Prints a report table. Small ones go through tabulate, styled by
+// `style`; large ones are streamed by TextTable instead.
+void printTable(const TextTable &rows, const function<void(Table &)> &style = styleHeaderRow)
+{
+    if (rows.size() > streamingTableThreshold)
+    {
+        rows.render(cout);
+        return;
+    }
+    Table table;
+    for (size_t row = 0; row < rows.size(); row++)
+    {
+        Table::Row_t cells;
+        for (size_t column = 0; column < rows.columns(); column++)
+            cells.push_back(string(rows.cell(row, column)));
+        table.add_row(cells);
+    }
+    style(table);
+    cout << table << endl;
+}
+
+// Pages through the employees at the given slots, formatting only the rows
+// of the page on screen. Column widths are measured once on an evenly
+// spaced sample of the rows, so they stay put from page to page without a
+// pass over the whole roster; longer values wrap within their column.
+class EmployeePager
+{
+public:
+    static constexpr size_t pageSize = 25;
+    static constexpr size_t widthSample = 1000;
+    static constexpr size_t maxColumnWidth = 32;
+
+private:
+    const vector<Employee> &employees;
+    const vector<uint32_t> &order;
+    vector<size_t> widths;
+
+    static vector<string> header() { return {"ID", "Name", "Department", "Position", "Salary", "Status"}; }
+
+    static vector<string> cells(const Employee &emp)
+    {
+        return {to_string(emp.id), emp.name, emp.department.str(), emp.position.str(), emp.salary.toString(), emp.hiringStatus.str()};
+    }
+
+    void measureColumns()
+    {
+        vector<string> names = header();
+        widths.assign(names.size(), 0);
+        for (size_t c = 0; c < names.size(); c++)
+            widths[c] = names[c].size();
+        size_t step = max<size_t>(1, order.size() / widthSample);
+        for (size_t i = 0; i < order.size(); i += step)
+        {
+            vector<string> row = cells(employees[order[i]]);
+            for (size_t c = 0; c < row.size(); c++)
+                widths[c] = min(maxColumnWidth, max(widths[c], row[c].size()));
+        }
+    }
+
+public:
+    EmployeePager(const vector<Employee> &allEmployees, const vector<uint32_t> &slots) : employees(allEmployees), order(slots)
+    {
+        measureColumns();
+    }
+
+    size_t pageCount() const { return (order.size() + pageSize - 1) / pageSize; }
+
+    void printPage(size_t page) const
+    {
+        Table table;
+        vector<string> names = header();
+        table.add_row(Table::Row_t(names.begin(), names.end()));
+        table[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
+        size_t end = min(order.size(), (page + 1) * pageSize);
+        for (size_t i = page * pageSize; i < end; i++)
+        {
+            vector<string> row = cells(employees[order[i]]);
+            table.add_row(Table::Row_t(row.begin(), row.end()));
+        }
+        for (size_t c = 0; c < widths.size(); c++)
+            table.column(c).format().width(widths[c] + 2); // Plus the cell padding
+        cout << table << endl;
+    }
+
+    // Shows the first page and then reads commands until the user quits:
+    // n (next), p (previous), a page number, or q. A roster that fits on
+    // one page is printed without prompting.
+    void run() const
+    {
+        size_t pages = pageCount();
+        size_t page = 0;
+        printPage(page);
+        while (pages > 1)
+        {
+            cout << blue("Page ") << page + 1 << blue(" of ") << pages << blue(" (") << order.size() << blue(" employees)") << endl;
+            cout << blue("[n]ext, [p]revious, page number, or [q]uit: ");
+            string command;
+            if (!(cin >> command) || command == "q" || command == "Q")
+                return;
+            if ((command == "n" || command == "N") && page + 1 < pages)
+            {
+                page++;
+            }
+            else if ((command == "p" || command == "P") && page > 0)
+            {
+                page--;
+            }
+            else if (command.size() < 10 && all_of(command.begin(), command.end(), [](unsigned char ch)
+                                                    { return isdigit(ch); }) &&
+                     stoul(command) >= 1 && stoul(command) <= pages)
+            {
+                page = stoul(command) - 1;
+            }
+            else
+            {
+                cout << red("No such page.") << endl;
+                continue;
+            }
+            Screen::get().clear();
+            printPage(page);
+        }
+    }
+};
+
+// Sorts the roster in place by one of the keys name, salary or department.
+// Only used to replay journals written by versions that sorted the roster
+// itself; sorting is now a view (EmployeeOrder). Stable, so replay gives
+// the same order.
+bool sortEmployeesByKey(vector<Employee> &employees, const string &sortBy)
+{
+    if (sortBy == "name")
+    {
+        stable_sort(employees.begin(), employees.end(), [](const Employee &a, const Employee &b)
+                    { return a.name < b.name; });
+    }
+    else if (sortBy == "salary")
+    {
+        stable_sort(employees.begin(), employees.end(), [](const Employee &a, const Employee &b)
+                    { return a.salary < b.salary; });
+    }
+    else if (sortBy == "department")
+    {
+        stable_sort(employees.begin(), employees.end(), [](const Employee &a, const Employee &b)
+                    { return a.department < b.department; });
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+// --- PERSISTENCE ---
+
+// Collections that are persisted separately, so a save can skip the ones
+// that did not change
+enum DataSection : uint32_t
+{
+    SECTION_EMPLOYEES = 1,
+    SECTION_ATTENDANCE = 2,
+    SECTION_CLIENTS = 4,
+    SECTION_PROJECTS = 8,
+    ALL_SECTIONS = SECTION_EMPLOYEES | SECTION_ATTENDANCE | SECTION_CLIENTS | SECTION_PROJECTS
+};
+
+// Append-only change journal (write-ahead log).
+// Every mutation appends one small tab-separated record instead of rewriting
+// the whole data file. Checkpoints rotate the journal aside, write the
+// snapshot and then drop the rotated part. On startup the journal tail is
+// replayed on top of the last checkpoint.
+//
+// Records carry the full state of the touched entity, so replaying a record
+// that is already part of the checkpoint is harmless.
+class ChangeJournal
+{
+private:
+    const string journalFile;
+    const string rotatedFile;  // Records captured by a checkpoint still being written
+    size_t pendingRecords;     // Records written since the last rotation
+    uint32_t pendingSections;  // DataSection bits touched since the last rotation
+    uint32_t rotatedSections;  // DataSection bits touched by the rotated records
+    bool flushEachRecord;      // Off while a batch buffers its records
+    ofstream out;
+
+    static string escapeField(const string &value)
+    {
+        string escaped;
+        escaped.reserve(value.size());
+        for (char c : value)
+        {
+            switch (c)
+            {
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\r':
+                escaped += "\\r";
+                break;
+            default:
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    static vector<string> splitRecord(const string &line)
+    {
+        vector<string> fields(1);
+        for (size_t i = 0; i < line.size(); i++)
+        {
+            char c = line[i];
+            if (c == '\t')
+            {
+                fields.emplace_back();
+            }
+            else if (c == '\\' && i + 1 < line.size())
+            {
+                char next = line[++i];
+                fields.back() += (next == 't' ? '\t' : next == 'n' ? '\n' : next == 'r' ? '\r' : next);
+            }
+            else
+            {
+                fields.back() += c;
+            }
+        }
+        return fields;
+    }
+
+    // Doubles are written in the shortest form that reads back exactly,
+    // so a replay is exact
+    static string formatNumber(double value)
+    {
+        char buffer[formatBufferSize];
+        return string(buffer, formatShortest(buffer, buffer + sizeof(buffer), value));
+    }
+
+    void append(const vector<string> &fields, uint32_t sections)
+    {
+        pendingSections |= sections;
+        if (!out.is_open())
+        {
+            out.open(journalFile, ios::binary | ios::app); // Binary so records end in a bare '\n' on Windows too
+            if (!out.is_open())
+            {
+                cerr << red("Error: Could not open ") << journalFile << red(" for writing.") << endl;
+                return;
+            }
+        }
+        string line;
+        for (size_t i = 0; i < fields.size(); i++)
+        {
+            if (i > 0)
+                line += '\t';
+            line += escapeField(fields[i]);
+        }
+        line += '\n';
+        out << line;
+        if (flushEachRecord)
+            out.flush(); // Hand the record to the OS before the menu moves on
+        pendingRecords++;
+    }
+
+    static uint32_t sectionsOf(const string &type)
+    {
+        if (type == "E" || type == "S")
+            return SECTION_EMPLOYEES;
+        if (type == "e")
+            return SECTION_EMPLOYEES | SECTION_ATTENDANCE;
+        if (type == "A")
+            return SECTION_ATTENDANCE;
+        if (type == "C")
+            return SECTION_CLIENTS;
+        if (type == "P")
+            return SECTION_PROJECTS;
+        return SECTION_PROJECTS | SECTION_EMPLOYEES;
+    }
+
+public:
+    ChangeJournal(const string &file)
+        : journalFile(file), rotatedFile(file + ".old"), pendingRecords(0), pendingSections(0), rotatedSections(0), flushEachRecord(true) {}
+
+    // Batch mode lets records pile up in the stream buffer instead of
+    // flushing each one; turning it back on flushes what is buffered
+    void setFlushEachRecord(bool enabled)
+    {
+        flushEachRecord = enabled;
+        if (enabled && out.is_open())
+            out.flush();
+    }
+
+    void employeeUpserted(const Employee &emp)
+    {
+        append({"E", to_string(emp.id), emp.name, emp.department.str(), emp.position.str(), emp.salary.toString(),
+                emp.hiringStatus.str(), formatNumber(emp.hoursWorked), formatNumber(emp.vacationDays),
+                formatNumber(emp.sickDays), formatNumber(emp.otherLeaveDays),
+                to_string(emp.assignedClientId), to_string(emp.assignedProjectId)},
+               SECTION_EMPLOYEES);
+    }
+
+    void employeeDeleted(int id)
+    {
+        append({"e", to_string(id)}, SECTION_EMPLOYEES | SECTION_ATTENDANCE);
+    }
+
+    void attendanceRecorded(int empId, const Date &date, bool present)
+    {
+        append({"A", to_string(empId), to_string(date.year), to_string(date.month), to_string(date.day), present ? "1" : "0"}, SECTION_ATTENDANCE);
+    }
+
+    void clientUpserted(const Client &client)
+    {
+        append({"C", to_string(client.id), client.name, client.contactPerson, client.contactEmail}, SECTION_CLIENTS);
+    }
+
+    void projectUpserted(const Project &proj)
+    {
+        append({"P", to_string(proj.id), proj.name, proj.description, to_string(proj.deadline.year),
+                to_string(proj.deadline.month), to_string(proj.deadline.day), to_string(proj.clientId)},
+               SECTION_PROJECTS);
+    }
+
+    void projectDeleted(int id)
+    {
+        append({"p", to_string(id)}, SECTION_PROJECTS | SECTION_EMPLOYEES); // Assignments are reset too
+    }
+
+    size_t pending() const { return pendingRecords; }
+    bool hasRotated() const
+    {
+        error_code ec;
+        return filesystem::exists(rotatedFile, ec);
+    }
+
+    // Moves the records written so far aside while a checkpoint containing
+    // them is written. If an earlier checkpoint failed, its rotated records
+    // are kept and the new ones are appended after them. Returns the
+    // DataSection bits the checkpoint has to rewrite.
+    uint32_t rotate()
+    {
+        if (out.is_open())
+            out.close();
+        rotatedSections |= pendingSections;
+        pendingSections = 0;
+        error_code ec;
+        if (!filesystem::exists(journalFile, ec))
+        {
+            pendingRecords = 0;
+            return rotatedSections;
+        }
+        if (hasRotated())
+        {
+            ifstream in(journalFile, ios::binary);
+            ofstream rotated(rotatedFile, ios::binary | ios::app);
+            rotated << in.rdbuf();
+            in.close();
+            ofstream truncate(journalFile, ios::trunc);
+        }
+        else
+        {
+            filesystem::rename(journalFile, rotatedFile);
+        }
+        pendingRecords = 0;
+        return rotatedSections;
+    }
+
+    // Called once the checkpoint covering the rotated records is on disk
+    void dropRotated()
+    {
+        rotatedSections = 0;
+        error_code ec;
+        filesystem::remove(rotatedFile, ec);
+    }
+
+    // Applies every complete record on top of the loaded checkpoint, the
+    // rotated part first. Returns the number of records replayed.
+    // The indexes must be current for `employees` and `projects` and are kept current.
+    size_t replay(vector<Employee> &employees, EmployeeIndex &employeeIndex, vector<Client> &clients, vector<Project> &projects,
+                  ProjectIndex &projectIndex, int &nextEmployeeId, int &nextClientId, int &nextProjectId)
+    {
+        pendingRecords = replayFile(rotatedFile, employees, employeeIndex, clients, projects, projectIndex, nextEmployeeId, nextClientId, nextProjectId) +
+                         replayFile(journalFile, employees, employeeIndex, clients, projects, projectIndex, nextEmployeeId, nextClientId, nextProjectId);
+        return pendingRecords;
+    }
+
+private:
+    size_t replayFile(const string &path, vector<Employee> &employees, EmployeeIndex &employeeIndex, vector<Client> &clients,
+                      vector<Project> &projects, ProjectIndex &projectIndex, int &nextEmployeeId, int &nextClientId, int &nextProjectId)
+    {
+        ifstream in(path, ios::binary);
+        if (!in.is_open())
+            return 0;
+
+        string content((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        size_t replayed = 0;
+        size_t start = 0;
+        while (start < content.size())
+        {
+            size_t end = content.find('\n', start);
+            if (end == string::npos)
+                break; // Torn tail from an interrupted write, ignore it
+            size_t length = end - start;
+            if (length > 0 && content[end - 1] == '\r')
+                length--; // Journals written in text mode on Windows end records in "\r\n"
+            vector<string> f = splitRecord(content.substr(start, length));
+            start = end + 1;
+
+            try
+            {
+                const string &type = f[0];
+                if (type == "E" && f.size() == 13)
+                {
+                    int id = stoi(f[1]);
+                    Employee *emp = employeeIndex.find(id);
+                    if (!emp)
+                    {
+                        employees.emplace_back(id, f[2], f[3], f[4], Money::parse(f[5]));
+                        employeeIndex.added();
+                        emp = &employees.back();
+                    }
+                    emp->name = f[2];
+                    emp->department = f[3];
+                    emp->position = f[4];
+                    emp->salary = Money::parse(f[5]);
+                    emp->hiringStatus = f[6];
+                    emp->hoursWorked = stod(f[7]);
+                    emp->vacationDays = stod(f[8]);
+                    emp->sickDays = stod(f[9]);
+                    emp->otherLeaveDays = stod(f[10]);
+                    emp->assignedClientId = stoi(f[11]);
+                    emp->assignedProjectId = stoi(f[12]);
+                    employeeIndex.changed(*emp);
+                    nextEmployeeId = max(nextEmployeeId, id + 1);
+                }
+                else if (type == "e" && f.size() == 2)
+                {
+                    employeeIndex.remove(stoi(f[1]));
+                }
+                else if (type == "A" && f.size() == 6)
+                {
+                    Date date{stoi(f[2]), stoi(f[3]), stoi(f[4])};
+                    Employee *emp = employeeIndex.find(stoi(f[1]));
+                    if (emp && emp->attendance.set(date, f[5] == "1"))
+                        employeeIndex.attendanceRecorded(*emp, date, f[5] == "1");
+                }
+                else if (type == "S" && f.size() == 2) // Only in journals from older versions
+                {
+                    employeeIndex.compact();
+                    sortEmployeesByKey(employees, f[1]);
+                    employeeIndex.rebuild();
+                }
+                else if (type == "C" && f.size() == 5)
+                {
+                    int id = stoi(f[1]);
+                    auto it = find_if(clients.begin(), clients.end(), [id](const Client &c)
+                                      { return c.id == id; });
+                    if (it == clients.end())
+                        clients.emplace_back(id, f[2], f[3], f[4]);
+                    else
+                        *it = Client(id, f[2], f[3], f[4]);
+                    nextClientId = max(nextClientId, id + 1);
+                }
+                else if (type == "P" && f.size() == 8)
+                {
+                    int id = stoi(f[1]);
+                    Project proj(id, f[2], f[3], Date{stoi(f[4]), stoi(f[5]), stoi(f[6])}, stoi(f[7]));
+                    if (Project *existing = projectIndex.find(id))
+                    {
+                        *existing = proj;
+                        projectIndex.changed(proj);
+                    }
+                    else
+                    {
+                        projects.push_back(proj);
+                        projectIndex.added();
+                    }
+                    nextProjectId = max(nextProjectId, id + 1);
+                }
+                else if (type == "p" && f.size() == 2)
+                {
+                    int id = stoi(f[1]);
+                    projectIndex.remove(id);
+                    employeeIndex.unassignProject(id);
+                }
+                else
+                {
+                    cerr << yellow("Warning: Skipping malformed journal record.") << endl;
+                    continue;
+                }
+                pendingSections |= sectionsOf(type);
+                replayed++;
+            }
+            catch (const std::exception &e)
+            {
+                cerr << yellow("Warning: Skipping unreadable journal record: ") << e.what() << endl;
+            }
+        }
+        return replayed;
+    }
+};
+
+// Streaming import of the xlsx workbook.
+// Instead of building xlnt's in-memory workbook model, each sheet is read
+// cell by cell with xlnt's streaming reader and decoded row by row straight
+// into Employee/Client/Project objects. The Employees, Attendance, Clients
+// and Projects sheets are parsed concurrently, each by its own reader over
+// the same in-memory copy of the file.
+class WorkbookImporter
+{
+private:
+    // Values of one cell, captured before the reader moves on
+    struct SheetCell
+    {
+        bool present = false;
+        double number = 0;
+        string text;
+
+        int asInt() const { return static_cast<int>(llround(number)); }
+        double asDouble() const { return number; }
+        bool asBool() const { return number != 0; }
+    };
+
+    using SheetRow = vector<SheetCell>;
+
+    // Streams one sheet and calls onRow for every data row (row 1 is the header)
+    template <typename RowHandler>
+    static bool readSheet(const vector<uint8_t> &bytes, const string &title, size_t columns, RowHandler onRow)
+    {
+        xlnt::streaming_workbook_reader reader;
+        reader.open(bytes);
+        if (!reader.has_worksheet(title))
+            return false;
+        reader.begin_worksheet(title);
+
+        SheetRow row(columns);
+        uint32_t currentRow = 0;
+        while (reader.has_cell())
+        {
+            xlnt::cell cell = reader.read_cell();
+            if (cell.row() != currentRow)
+            {
+                if (currentRow > 1)
+                    onRow(row);
+                row.assign(columns, SheetCell());
+                currentRow = cell.row();
+            }
+            size_t column = cell.column().index;
+            if (column < 1 || column > columns || !cell.has_value())
+                continue;
+
+            SheetCell &value = row[column - 1];
+            value.present = true;
+            value.text = cell.to_string();
+            if (cell.data_type() == xlnt::cell_type::number)
+                value.number = cell.value<double>();
+            else if (cell.data_type() == xlnt::cell_type::boolean)
+                value.number = cell.value<bool>() ? 1 : 0;
+            else
+                value.number = strtod(value.text.c_str(), nullptr);
+        }
+        if (currentRow > 1)
+            onRow(row);
+        reader.end_worksheet();
+        return true;
+    }
+
+    struct AttendanceRow
+    {
+        int employeeId;
+        Date date;
+        bool present;
+    };
+
+public:
+    static void load(const string &path, vector<Employee> &employees, vector<Client> &clients, vector<Project> &projects,
+                     int &nextEmployeeId, int &nextClientId, int &nextProjectId)
+    {
+        ifstream in(path, ios::binary);
+        if (!in.is_open())
+            throw runtime_error("could not open " + path);
+        const vector<uint8_t> bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        in.close();
+
+        auto employeeSheet = async(launch::async, [&bytes]
+                                   {
+            vector<Employee> rows;
+            if (!readSheet(bytes, "Employees", 12, [&rows](const SheetRow &row)
+                           {
+                Employee emp(row[0].asInt(), row[1].text, row[2].text, row[3].text, Money::fromDouble(row[4].asDouble()));
+                emp.hiringStatus = row[5].text;
+                emp.hoursWorked = row[6].asDouble();
+                emp.vacationDays = row[7].asDouble();
+                emp.sickDays = row[8].asDouble();
+                emp.otherLeaveDays = row[9].asDouble();
+                emp.assignedClientId = row[10].present ? row[10].asInt() : -1;
+                emp.assignedProjectId = row[11].present ? row[11].asInt() : -1;
+                rows.push_back(move(emp)); }))
+                throw runtime_error("workbook has no Employees sheet");
+            return rows; });
+
+        auto attendanceSheet = async(launch::async, [&bytes]
+                                     {
+            vector<AttendanceRow> rows;
+            readSheet(bytes, "Attendance", 5, [&rows](const SheetRow &row)
+                      { rows.push_back({row[0].asInt(), Date{row[1].asInt(), row[2].asInt(), row[3].asInt()}, row[4].asBool()}); });
+            return rows; });
+
+        auto clientSheet = async(launch::async, [&bytes]
+                                 {
+            vector<Client> rows;
+            if (!readSheet(bytes, "Clients", 4, [&rows](const SheetRow &row)
+                           { rows.emplace_back(row[0].asInt(), row[1].text, row[2].text, row[3].text); }))
+                throw runtime_error("workbook has no Clients sheet");
+            return rows; });
+
+        auto projectSheet = async(launch::async, [&bytes]
+                                  {
+            vector<Project> rows;
+            if (!readSheet(bytes, "Projects", 7, [&rows](const SheetRow &row)
+                           { rows.emplace_back(row[0].asInt(), row[1].text, row[2].text, Date{row[3].asInt(), row[4].asInt(), row[5].asInt()}, row[6].asInt()); }))
+                throw runtime_error("workbook has no Projects sheet");
+            return rows; });
+
+        // The metadata sheet is tiny, read it here while the others stream.
+        // Row 1 holds data in this sheet, so it is read without readSheet.
+        int metadata[3] = {1, 1, 1};
+        {
+            xlnt::streaming_workbook_reader reader;
+            reader.open(bytes);
+            if (!reader.has_worksheet("Metadata"))
+                throw runtime_error("workbook has no Metadata sheet");
+            reader.begin_worksheet("Metadata");
+            while (reader.has_cell())
+            {
+                xlnt::cell cell = reader.read_cell();
+                if (cell.column().index == 2 && cell.row() >= 1 && cell.row() <= 3)
+                    metadata[cell.row() - 1] = cell.value<int>();
+            }
+            reader.end_worksheet();
+        }
+
+        // get() rethrows anything a sheet thread threw. Every future is
+        // waited on before leaving so no thread outlives the shared bytes.
+        vector<Employee> loadedEmployees;
+        vector<AttendanceRow> attendance;
+        vector<Client> loadedClients;
+        vector<Project> loadedProjects;
+        exception_ptr failure;
+        auto collect = [&failure](auto &sheet, auto &rows)
+        {
+            try
+            {
+                rows = sheet.get();
+            }
+            catch (...)
+            {
+                failure = current_exception();
+            }
+        };
+        collect(employeeSheet, loadedEmployees);
+        collect(attendanceSheet, attendance);
+        collect(clientSheet, loadedClients);
+        collect(projectSheet, loadedProjects);
+        if (failure)
+            rethrow_exception(failure);
+
+        unordered_map<int, size_t> slotById;
+        for (size_t i = 0; i < loadedEmployees.size(); i++)
+            slotById[loadedEmployees[i].id] = i;
+        for (const AttendanceRow &record : attendance)
+        {
+            auto slot = slotById.find(record.employeeId);
+            if (slot != slotById.end())
+                loadedEmployees[slot->second].attendance.set(record.date, record.present);
+        }
+
+        employees = move(loadedEmployees);
+        clients = move(loadedClients);
+        projects = move(loadedProjects);
+        nextEmployeeId = metadata[0];
+        nextClientId = metadata[1];
+        nextProjectId = metadata[2];
+    }
+};
+
+// Background saver. Mutations only mark the data dirty; the worker waits
+// until edits pause (or the oldest unsaved edit gets too old) so a burst of
+// edits turns into a single save, which then runs off the UI thread.
+class PersistenceWorker
+{
+private:
+    function<bool()> save; // Writes a checkpoint, returns false on failure
+    const chrono::milliseconds quietPeriod;
+    const chrono::milliseconds maxDelay;
+
+    mutex stateMutex;
+    condition_variable wake;
+    bool dirty = false;
+    bool stopping = false;
+    chrono::steady_clock::time_point firstDirty;
+    chrono::steady_clock::time_point lastDirty;
+    thread worker;
+
+    void loop()
+    {
+        unique_lock<mutex> lock(stateMutex);
+        while (true)
+        {
+            wake.wait(lock, [this]
+                      { return dirty || stopping; });
+            // Coalesce the burst
+            while (!stopping)
+            {
+                auto deadline = min(lastDirty + quietPeriod, firstDirty + maxDelay);
+                if (chrono::steady_clock::now() >= deadline)
+                    break;
+                wake.wait_until(lock, deadline);
+            }
+            if (stopping)
+                return; // The owner flushes whatever is left
+
+            dirty = false;
+            lock.unlock();
+            bool saved = save();
+            lock.lock();
+            if (!saved && !dirty)
+            {
+                // Try again after the next quiet period
+                dirty = true;
+                firstDirty = lastDirty = chrono::steady_clock::now();
+            }
+        }
+    }
+
+public:
+    PersistenceWorker(function<bool()> saveCallback,
+                      chrono::milliseconds quiet = chrono::milliseconds(1500),
+                      chrono::milliseconds maxWait = chrono::milliseconds(10000))
+        : save(move(saveCallback)), quietPeriod(quiet), maxDelay(maxWait) {}
+
+    ~PersistenceWorker() { stop(); }
+
+    void start()
+    {
+        if (!worker.joinable())
+            worker = thread(&PersistenceWorker::loop, this);
+    }
+
+    void markDirty()
+    {
+        lock_guard<mutex> lock(stateMutex);
+        auto now = chrono::steady_clock::now();
+        if (!dirty)
+            firstDirty = now;
+        lastDirty = now;
+        dirty = true;
+        wake.notify_one();
+    }
+
+    // Waits for a save in progress and stops the worker
+    void stop()
+    {
+        {
+            lock_guard<mutex> lock(stateMutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        if (worker.joinable())
+            worker.join();
+    }
+};
+
+// Native binary snapshot of all worker data.
+//
+// Every file has the same layout: a fixed header, a column directory, then
+// the column data. Tables are stored column by column as fixed-width arrays
+// (8-byte aligned); strings are stored once in a per-file string table and
+// referenced by index. Files are mapped into memory and decoded straight
+// from the mapping, so loading does almost no parsing. The xlsx workbook is
+// only an export format.
+//
+// Since version 2 each collection lives in its own segment file next to the
+// snapshot (worker_data.snap.employees, ...), and worker_data.snap itself
+// only holds the counters. A save rewrites just the segments of collections
+// that changed. Version 1 kept every table in worker_data.snap and can still
+// be loaded. Version 3 stores salaries as integer cents (emp.salaryCents)
+// instead of doubles (emp.salary).
+class BinarySnapshot
+{
+private:
+    static constexpr char magic[8] = {'W', 'M', 'S', 'S', 'N', 'A', 'P', '\0'};
+    static constexpr uint32_t formatVersion = 3;
+    static constexpr uint32_t oldestReadableVersion = 1;
+    static constexpr uint32_t endianMarker = 0x01020304;
+
+    enum ColumnType : uint32_t
+    {
+        COL_I32 = 1,
+        COL_F64 = 2,
+        COL_U8 = 3,
+        COL_U32 = 4,
+        COL_STR = 5, // uint32 index into the string table
+        COL_I64 = 6
+    };
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t endian;
+        uint64_t fileSize;
+        uint32_t columnCount;
+        int32_t nextEmployeeId;
+        int32_t nextClientId;
+        int32_t nextProjectId;
+        uint8_t workbookInSync; // Written right after an xlsx export
+        uint8_t reserved[23];
+    };
+
+    struct ColumnEntry
+    {
+        char name[16];
+        uint32_t type;
+        uint32_t count;
+        uint64_t offset;
+        uint64_t bytes;
+    };
+
+    static_assert(sizeof(Header) == 64, "snapshot header must stay 64 bytes");
+    static_assert(sizeof(ColumnEntry) == 40, "snapshot column entry must stay 40 bytes");
+
+    static int32_t packDate(const Date &date) { return date.year * 10000 + date.month * 100 + date.day; }
+    static Date unpackDate(int32_t packed) { return {packed / 10000, (packed / 100) % 100, packed % 100}; }
+
+    // Collects columns and the string table in memory, then writes the file
+    class Writer
+    {
+    private:
+        vector<ColumnEntry> columns;
+        vector<char> data;
+        unordered_map<string, uint32_t> stringIds;
+        vector<uint32_t> stringOffsets{0};
+        string stringBytes;
+
+        void addRaw(const char *name, uint32_t type, uint32_t count, const void *values, size_t bytes)
+        {
+            ColumnEntry entry{};
+            strncpy(entry.name, name, sizeof(entry.name) - 1);
+            entry.type = type;
+            entry.count = count;
+            entry.offset = data.size(); // Relative to the data area until finish()
+            entry.bytes = bytes;
+            columns.push_back(entry);
+            const char *bytesIn = static_cast<const char *>(values);
+            data.insert(data.end(), bytesIn, bytesIn + bytes);
+            data.resize((data.size() + 7) & ~size_t(7), 0);
+        }
+
+    public:
+        uint32_t intern(const string &value)
+        {
+            auto it = stringIds.find(value);
+            if (it != stringIds.end())
+                return it->second;
+            uint32_t id = static_cast<uint32_t>(stringOffsets.size() - 1);
+            stringIds.emplace(value, id);
+            stringBytes += value;
+            stringOffsets.push_back(static_cast<uint32_t>(stringBytes.size()));
+            return id;
+        }
+
+        void add(const char *name, const vector<int32_t> &values) { addRaw(name, COL_I32, static_cast<uint32_t>(values.size()), values.data(), values.size() * sizeof(int32_t)); }
+        void add(const char *name, const vector<int64_t> &values) { addRaw(name, COL_I64, static_cast<uint32_t>(values.size()), values.data(), values.size() * sizeof(int64_t)); }
+        void add(const char *name, const vector<double> &values) { addRaw(name, COL_F64, static_cast<uint32_t>(values.size()), values.data(), values.size() * sizeof(double)); }
+        void add(const char *name, const vector<uint8_t> &values) { addRaw(name, COL_U8, static_cast<uint32_t>(values.size()), values.data(), values.size()); }
+        void addStrings(const char *name, const vector<uint32_t> &ids) { addRaw(name, COL_STR, static_cast<uint32_t>(ids.size()), ids.data(), ids.size() * sizeof(uint32_t)); }
+
+        void writeTo(const string &path, int nextEmployeeId, int nextClientId, int nextProjectId, bool workbookInSync)
+        {
+            // The string table goes last so every string column has been interned
+            addRaw("str.offsets", COL_U32, static_cast<uint32_t>(stringOffsets.size()), stringOffsets.data(), stringOffsets.size() * sizeof(uint32_t));
+            addRaw("str.bytes", COL_U8, static_cast<uint32_t>(stringBytes.size()), stringBytes.data(), stringBytes.size());
+
+            uint64_t dataStart = sizeof(Header) + columns.size() * sizeof(ColumnEntry);
+            dataStart = (dataStart + 7) & ~uint64_t(7);
+            for (ColumnEntry &entry : columns)
+                entry.offset += dataStart;
+
+            Header header{};
+            memcpy(header.magic, magic, sizeof(magic));
+            header.version = formatVersion;
+            header.endian = endianMarker;
+            header.fileSize = dataStart + data.size();
+            header.columnCount = static_cast<uint32_t>(columns.size());
+            header.nextEmployeeId = nextEmployeeId;
+            header.nextClientId = nextClientId;
+            header.nextProjectId = nextProjectId;
+            header.workbookInSync = workbookInSync ? 1 : 0;
+
+            const string tempFile = path + ".tmp";
+            {
+                ofstream out(tempFile, ios::binary | ios::trunc);
+                if (!out.is_open())
+                    throw runtime_error("could not open " + tempFile + " for writing");
+                out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+                out.write(reinterpret_cast<const char *>(columns.data()), columns.size() * sizeof(ColumnEntry));
+                string padding(dataStart - sizeof(Header) - columns.size() * sizeof(ColumnEntry), '\0');
+                out.write(padding.data(), padding.size());
+                out.write(data.data(), data.size());
+                if (!out)
+                    throw runtime_error("could not write " + tempFile);
+            }
+            filesystem::rename(tempFile, path);
+        }
+    };
+
+    // Validated view of one column inside the mapping
+    struct Column
+    {
+        const char *base = nullptr;
+        uint32_t count = 0;
+
+        template <typename T>
+        T at(size_t i) const
+        {
+            T value;
+            memcpy(&value, base + i * sizeof(T), sizeof(T));
+            return value;
+        }
+    };
+
+    class Reader
+    {
+    private:
+        const MappedFile &file;
+        map<string, pair<ColumnEntry, Column>> columns;
+        Column stringOffsets;
+        Column stringBytes;
+
+    public:
+        Header header;
+
+        Reader(const MappedFile &mapped) : file(mapped)
+        {
+            if (file.size() < sizeof(Header))
+                throw runtime_error("snapshot is truncated");
+            memcpy(&header, file.data(), sizeof(Header));
+            if (memcmp(header.magic, magic, sizeof(magic)) != 0)
+                throw runtime_error("not a worker data snapshot");
+            if (header.endian != endianMarker)
+                throw runtime_error("snapshot was written on a machine with different byte order");
+            if (header.version < oldestReadableVersion || header.version > formatVersion)
+                throw runtime_error("unsupported snapshot version " + to_string(header.version));
+            if (header.fileSize != file.size() ||
+                sizeof(Header) + uint64_t(header.columnCount) * sizeof(ColumnEntry) > file.size())
+                throw runtime_error("snapshot is truncated");
+
+            static const map<uint32_t, size_t> widths = {{COL_I32, 4}, {COL_F64, 8}, {COL_U8, 1}, {COL_U32, 4}, {COL_STR, 4}, {COL_I64, 8}};
+            for (uint32_t i = 0; i < header.columnCount; i++)
+            {
+                ColumnEntry entry;
+                memcpy(&entry, file.data() + sizeof(Header) + i * sizeof(ColumnEntry), sizeof(ColumnEntry));
+                auto width = widths.find(entry.type);
+                if (width == widths.end() || entry.bytes != uint64_t(entry.count) * width->second ||
+                    entry.offset > file.size() || entry.bytes > file.size() - entry.offset)
+                    throw runtime_error("snapshot column directory is corrupt");
+                string name(entry.name, strnlen(entry.name, sizeof(entry.name)));
+                columns[name] = {entry, Column{file.data() + entry.offset, entry.count}};
+            }
+
+            stringOffsets = column("str.offsets", COL_U32);
+            stringBytes = column("str.bytes", COL_U8);
+            if (stringOffsets.count == 0 || stringOffsets.at<uint32_t>(stringOffsets.count - 1) > stringBytes.count)
+                throw runtime_error("snapshot string table is corrupt");
+        }
+
+        bool has(const string &name, uint32_t type) const
+        {
+            auto it = columns.find(name);
+            return it != columns.end() && it->second.first.type == type;
+        }
+
+        Column column(const string &name, uint32_t type) const
+        {
+            auto it = columns.find(name);
+            if (it == columns.end() || it->second.first.type != type)
+                throw runtime_error("snapshot is missing column " + name);
+            return it->second.second;
+        }
+
+        // Columns of one table must all have the same number of rows
+        static uint32_t rows(initializer_list<Column> tableColumns)
+        {
+            uint32_t count = tableColumns.begin()->count;
+            for (const Column &c : tableColumns)
+            {
+                if (c.count != count)
+                    throw runtime_error("snapshot table has ragged columns");
+            }
+            return count;
+        }
+
+        string str(const Column &ids, size_t row) const
+        {
+            uint32_t id = ids.at<uint32_t>(row);
+            if (stringOffsets.count == 0 || id >= stringOffsets.count - 1)
+                throw runtime_error("snapshot string reference out of range");
+            uint32_t begin = stringOffsets.at<uint32_t>(id);
+            uint32_t end = stringOffsets.at<uint32_t>(id + 1);
+            if (begin > end || end > stringBytes.count)
+                throw runtime_error("snapshot string table is corrupt");
+            return string(stringBytes.base + begin, end - begin);
+        }
+    };
+
+    static string sectionFile(const string &path, DataSection section)
+    {
+        switch (section)
+        {
+        case SECTION_EMPLOYEES:
+            return path + ".employees";
+        case SECTION_ATTENDANCE:
+            return path + ".attendance";
+        case SECTION_CLIENTS:
+            return path + ".clients";
+        default:
+            return path + ".projects";
+        }
+    }
+
+    static void writeEmployees(const string &file, const vector<Employee> &employees)
+    {
+        Writer writer;
+        vector<int32_t> ids, clientIds, projectIds;
+        vector<uint32_t> names, departments, positions, statuses;
+        vector<int64_t> salaries;
+        vector<double> hours, vacation, sick, other;
+        for (const auto &emp : employees)
+        {
+            ids.push_back(emp.id);
+            names.push_back(writer.intern(emp.name));
+            departments.push_back(writer.intern(emp.department));
+            positions.push_back(writer.intern(emp.position));
+            salaries.push_back(emp.salary.minorUnits());
+            statuses.push_back(writer.intern(emp.hiringStatus));
+            hours.push_back(emp.hoursWorked);
+            vacation.push_back(emp.vacationDays);
+            sick.push_back(emp.sickDays);
+            other.push_back(emp.otherLeaveDays);
+            clientIds.push_back(emp.assignedClientId);
+            projectIds.push_back(emp.assignedProjectId);
+        }
+        writer.add("emp.id", ids);
+        writer.addStrings("emp.name", names);
+        writer.addStrings("emp.department", departments);
+        writer.addStrings("emp.position", positions);
+        writer.add("emp.salaryCents", salaries);
+        writer.addStrings("emp.status", statuses);
+        writer.add("emp.hours", hours);
+        writer.add("emp.vacation", vacation);
+        writer.add("emp.sick", sick);
+        writer.add("emp.otherLeave", other);
+        writer.add("emp.client", clientIds);
+        writer.add("emp.project", projectIds);
+        writer.writeTo(file, 0, 0, 0, false);
+    }
+
+    static void writeAttendance(const string &file, const vector<Employee> &employees)
+    {
+        Writer writer;
+        vector<int32_t> attEmployee, attDate;
+        vector<uint8_t> attPresent;
+        for (const auto &emp : employees)
+        {
+            emp.attendance.forEach([&](const Date &date, bool present)
+                                   {
+                attEmployee.push_back(emp.id);
+                attDate.push_back(packDate(date));
+                attPresent.push_back(present ? 1 : 0); });
+        }
+        writer.add("att.employee", attEmployee);
+        writer.add("att.date", attDate);
+        writer.add("att.present", attPresent);
+        writer.writeTo(file, 0, 0, 0, false);
+    }
+
+    static void writeClients(const string &file, const vector<Client> &clients)
+    {
+        Writer writer;
+        vector<int32_t> cliIds;
+        vector<uint32_t> cliNames, cliPersons, cliEmails;
+        for (const auto &client : clients)
+        {
+            cliIds.push_back(client.id);
+            cliNames.push_back(writer.intern(client.name));
+            cliPersons.push_back(writer.intern(client.contactPerson));
+            cliEmails.push_back(writer.intern(client.contactEmail));
+        }
+        writer.add("cli.id", cliIds);
+        writer.addStrings("cli.name", cliNames);
+        writer.addStrings("cli.person", cliPersons);
+        writer.addStrings("cli.email", cliEmails);
+        writer.writeTo(file, 0, 0, 0, false);
+    }
+
+    static void writeProjects(const string &file, const vector<Project> &projects)
+    {
+        Writer writer;
+        vector<int32_t> prjIds, prjDeadlines, prjClients;
+        vector<uint32_t> prjNames, prjDescriptions;
+        for (const auto &proj : projects)
+        {
+            prjIds.push_back(proj.id);
+            prjNames.push_back(writer.intern(proj.name));
+            prjDescriptions.push_back(writer.intern(proj.description));
+            prjDeadlines.push_back(packDate(proj.deadline));
+            prjClients.push_back(proj.clientId);
+        }
+        writer.add("prj.id", prjIds);
+        writer.addStrings("prj.name", prjNames);
+        writer.addStrings("prj.description", prjDescriptions);
+        writer.add("prj.deadline", prjDeadlines);
+        writer.add("prj.client", prjClients);
+        writer.writeTo(file, 0, 0, 0, false);
+    }
+
+    static void readEmployees(const Reader &reader, vector<Employee> &employees)
+    {
+        Column ids = reader.column("emp.id", COL_I32), names = reader.column("emp.name", COL_STR),
+               departments = reader.column("emp.department", COL_STR), positions = reader.column("emp.position", COL_STR),
+               statuses = reader.column("emp.status", COL_STR),
+               hours = reader.column("emp.hours", COL_F64), vacation = reader.column("emp.vacation", COL_F64),
+               sick = reader.column("emp.sick", COL_F64), other = reader.column("emp.otherLeave", COL_F64),
+               clientIds = reader.column("emp.client", COL_I32), projectIds = reader.column("emp.project", COL_I32);
+        // Snapshots before version 3 hold salaries as doubles
+        bool inCents = reader.has("emp.salaryCents", COL_I64);
+        Column salaries = inCents ? reader.column("emp.salaryCents", COL_I64) : reader.column("emp.salary", COL_F64);
+        uint32_t rows = Reader::rows({ids, names, departments, positions, salaries, statuses, hours, vacation, sick, other, clientIds, projectIds});
+
+        employees.reserve(rows);
+        for (uint32_t i = 0; i < rows; i++)
+        {
+            Money salary = inCents ? Money::fromCents(salaries.at<int64_t>(i)) : Money::fromDouble(salaries.at<double>(i));
+            Employee emp(ids.at<int32_t>(i), reader.str(names, i), reader.str(departments, i), reader.str(positions, i), salary);
+            emp.hiringStatus = reader.str(statuses, i);
+            emp.hoursWorked = hours.at<double>(i);
+            emp.vacationDays = vacation.at<double>(i);
+            emp.sickDays = sick.at<double>(i);
+            emp.otherLeaveDays = other.at<double>(i);
+            emp.assignedClientId = clientIds.at<int32_t>(i);
+            emp.assignedProjectId = projectIds.at<int32_t>(i);
+            employees.push_back(move(emp));
+        }
+    }
+
+    static void readAttendance(const Reader &reader, vector<Employee> &employees)
+    {
+        unordered_map<int, size_t> slotById;
+        for (size_t i = 0; i < employees.size(); i++)
+            slotById[employees[i].id] = i;
+
+        Column attEmployee = reader.column("att.employee", COL_I32), attDate = reader.column("att.date", COL_I32),
+               attPresent = reader.column("att.present", COL_U8);
+        uint32_t rows = Reader::rows({attEmployee, attDate, attPresent});
+        for (uint32_t i = 0; i < rows; i++)
+        {
+            auto slot = slotById.find(attEmployee.at<int32_t>(i));
+            if (slot != slotById.end())
+                employees[slot->second].attendance.set(unpackDate(attDate.at<int32_t>(i)), attPresent.at<uint8_t>(i) != 0);
+        }
+    }
+
+    static void readClients(const Reader &reader, vector<Client> &clients)
+    {
+        Column cliIds = reader.column("cli.id", COL_I32), cliNames = reader.column("cli.name", COL_STR),
+               cliPersons = reader.column("cli.person", COL_STR), cliEmails = reader.column("cli.email", COL_STR);
+        uint32_t rows = Reader::rows({cliIds, cliNames, cliPersons, cliEmails});
+        clients.reserve(rows);
+        for (uint32_t i = 0; i < rows; i++)
+            clients.emplace_back(cliIds.at<int32_t>(i), reader.str(cliNames, i), reader.str(cliPersons, i), reader.str(cliEmails, i));
+    }
+
+    static void readProjects(const Reader &reader, vector<Project> &projects)
+    {
+        Column prjIds = reader.column("prj.id", COL_I32), prjNames = reader.column("prj.name", COL_STR),
+               prjDescriptions = reader.column("prj.description", COL_STR), prjDeadlines = reader.column("prj.deadline", COL_I32),
+               prjClients = reader.column("prj.client", COL_I32);
+        uint32_t rows = Reader::rows({prjIds, prjNames, prjDescriptions, prjDeadlines, prjClients});
+        projects.reserve(rows);
+        for (uint32_t i = 0; i < rows; i++)
+            projects.emplace_back(prjIds.at<int32_t>(i), reader.str(prjNames, i), reader.str(prjDescriptions, i),
+                                  unpackDate(prjDeadlines.at<int32_t>(i)), prjClients.at<int32_t>(i));
+    }
 
-// Project Class (Core Data)
-class Project
-{
 public:
-    int id;
-    string name;
-    string description;
-    Date deadline;
-    int clientId; // Link to a client
+    // Renames the snapshot and its segments to *.corrupt, keeping an
+    // unreadable snapshot for inspection and out of the way of the next
+    // save. Returns false if the snapshot file itself could not be moved.
+    static bool setAside(const string &path)
+    {
+        error_code ec;
+        for (DataSection section : {SECTION_EMPLOYEES, SECTION_ATTENDANCE, SECTION_CLIENTS, SECTION_PROJECTS})
+        {
+            if (filesystem::exists(sectionFile(path, section), ec))
+                filesystem::rename(sectionFile(path, section), sectionFile(path, section) + ".corrupt", ec);
+        }
+        ec.clear();
+        filesystem::rename(path, path + ".corrupt", ec);
+        return !ec;
+    }
 
-    Project(int id, const string &name, const string &description, const Date &deadline, int clientId)
-        : id(id), name(name), description(description), deadline(deadline), clientId(clientId) {}
+    // Sections whose segment file is not on disk
+    static uint32_t missingSections(const string &path)
+    {
+        error_code ec;
+        uint32_t missing = 0;
+        for (DataSection section : {SECTION_EMPLOYEES, SECTION_ATTENDANCE, SECTION_CLIENTS, SECTION_PROJECTS})
+        {
+            if (!filesystem::exists(sectionFile(path, section), ec))
+                missing |= section;
+        }
+        return missing;
+    }
 
-    void display() const
+    // Rewrites the segments named in `sections` (and any that are missing),
+    // then the snapshot file with the counters. Untouched collections keep
+    // their previously written segment.
+    static void save(const string &path, const vector<Employee> &employees, const vector<Client> &clients,
+                     const vector<Project> &projects, int nextEmployeeId, int nextClientId, int nextProjectId,
+                     bool workbookInSync, uint32_t sections = ALL_SECTIONS)
     {
-        Table project_details;
-        project_details.add_row({"Attribute", "Value"});
-        project_details[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
-        project_details.add_row({"Project ID", to_string(id)});
-        project_details.add_row({"Name", name});
-        project_details.add_row({"Description", description});
-        project_details.add_row({"Deadline", deadline.toString()});
-        project_details.add_row({"Client ID", to_string(clientId)});
-        cout << project_details << endl;
+        error_code ec;
+        auto due = [&](DataSection section)
+        {
+            return (sections & section) || !filesystem::exists(sectionFile(path, section), ec);
+        };
+        if (due(SECTION_EMPLOYEES))
+            writeEmployees(sectionFile(path, SECTION_EMPLOYEES), employees);
+        if (due(SECTION_ATTENDANCE))
+            writeAttendance(sectionFile(path, SECTION_ATTENDANCE), employees);
+        if (due(SECTION_CLIENTS))
+            writeClients(sectionFile(path, SECTION_CLIENTS), clients);
+        if (due(SECTION_PROJECTS))
+            writeProjects(sectionFile(path, SECTION_PROJECTS), projects);
+
+        // The counters go last; a crash before this point is covered by the
+        // journal, which is only dropped after save() returns
+        Writer manifest;
+        manifest.writeTo(path, nextEmployeeId, nextClientId, nextProjectId, workbookInSync);
+    }
+
+    // Returns false when there is no snapshot; throws if it is unreadable.
+    // `segmented` is false for a version 1 snapshot, whose data is not in
+    // segment files yet; the next save must then rewrite every section.
+    static bool load(const string &path, vector<Employee> &employees, vector<Client> &clients,
+                     vector<Project> &projects, int &nextEmployeeId, int &nextClientId, int &nextProjectId,
+                     bool &workbookInSync, bool &segmented)
+    {
+        MappedFile file;
+        if (!file.open(path))
+            return false;
+        Reader manifest(file);
+
+        // Version 1 snapshots keep every table in the snapshot file itself
+        auto readSection = [&](DataSection section, auto decode)
+        {
+            if (manifest.header.version == 1)
+            {
+                decode(manifest);
+                return;
+            }
+            MappedFile segmentFile;
+            if (!segmentFile.open(sectionFile(path, section)))
+                throw runtime_error("snapshot segment " + sectionFile(path, section) + " is missing");
+            Reader segment(segmentFile);
+            decode(segment);
+        };
+
+        vector<Employee> loadedEmployees;
+        vector<Client> loadedClients;
+        vector<Project> loadedProjects;
+        readSection(SECTION_EMPLOYEES, [&](const Reader &reader)
+                    { readEmployees(reader, loadedEmployees); });
+        readSection(SECTION_ATTENDANCE, [&](const Reader &reader)
+                    { readAttendance(reader, loadedEmployees); });
+        readSection(SECTION_CLIENTS, [&](const Reader &reader)
+                    { readClients(reader, loadedClients); });
+        readSection(SECTION_PROJECTS, [&](const Reader &reader)
+                    { readProjects(reader, loadedProjects); });
+
+        // Only touch the live data once the whole snapshot decoded cleanly
+        employees = move(loadedEmployees);
+        clients = move(loadedClients);
+        projects = move(loadedProjects);
+        nextEmployeeId = manifest.header.nextEmployeeId;
+        nextClientId = manifest.header.nextClientId;
+        nextProjectId = manifest.header.nextProjectId;
+        workbookInSync = manifest.header.workbookInSync != 0;
+        segmented = manifest.header.version >= 2;
+        return true;
     }
 };
 
@@ -166,8 +3237,8 @@ public:
 class UserAuthenticationSystem
 {
 private:
-    vector<User> &users; // Reference to the main users vector
-    User *&currentUser;  // Reference to the main current user pointer
+    SlotMap<User> &users;               // Reference to the main user store
+    SlotMap<User>::Handle &currentUser; // Reference to the main current user handle
     const int codeAdmin = 123;
     const int codeManager =321;
     const string userCsvFile = "users.csv";
@@ -220,7 +3291,7 @@ private:
                 try
                 {
                     UserRole role = static_cast<UserRole>(stoi(roleStr));
-                    users.emplace_back(username, password, role);
+                    users.emplace(username, password, role);
                 }
                 catch (const std::invalid_argument &ia)
                 {
@@ -232,13 +3303,13 @@ private:
     }
 
 public:
-    UserAuthenticationSystem(vector<User> &allUsers, User *&activeUser) : users(allUsers), currentUser(activeUser)
+    UserAuthenticationSystem(SlotMap<User> &allUsers, SlotMap<User>::Handle &activeUser) : users(allUsers), currentUser(activeUser)
     {
         loadUsersFromCSV(); // Load users from CSV on startup
         if (users.empty())
         {
             // If no users are loaded (e.g., first run), create a default admin
-            users.emplace_back("admin", "admin123", ADMIN);
+            users.emplace("admin", "admin123", ADMIN);
             saveUsersToCSV(); // Save the new default admin user
         }
     }
@@ -272,7 +3343,7 @@ public:
         string username, password;
         UserRole role;
 
-        system("cls");
+        Screen::get().clear();
         printtHeader("Sign UP");
         cout << "Enter Username: ";
         cin >> username;
@@ -305,7 +3376,7 @@ public:
             }
         }
 
-        users.emplace_back(username, password, role);
+        users.emplace(username, password, role);
         saveUsersToCSV(); // Auto-save after adding a new user
         cout << green("Signup successful!\n");
         pressEnter();
@@ -313,7 +3384,7 @@ public:
 
     void signIn()
     {
-        system("cls");
+        Screen::get().clear();
         printHeaderStyle3("---|Sign In System|---");
         string username, password;
         cout << "Enter Username: ";
@@ -321,15 +3392,16 @@ public:
         cout << "Enter Password: ";
         cin >> password;
 
-        for (User &user : users)
+        for (size_t i = 0; i < users.size(); i++)
         {
+            const User &user = *users.get(users.handleAt(i));
             if (user.username == username && user.password == password)
             {
-                currentUser = &user;
-                cout << green(">> Login successful. Welcome, ") << currentUser->username << green("!") << endl;
+                currentUser = users.handleAt(i);
+                cout << green(">> Login successful. Welcome, ") << user.username << green("!") << endl;
                 cout << endl;
                 cout << bold_cyan("Role: ");
-                switch (currentUser->role)
+                switch (user.role)
                 {
                 case ADMIN:
                     cout << "Admin";
@@ -347,13 +3419,13 @@ public:
             }
         }
         cout << red("Login failed. Invalid credentials.") << endl;
-        currentUser = nullptr;
+        currentUser = {};
         pressEnter();
     }
 
     void logout()
     {
-        currentUser = nullptr;
+        currentUser = {};
         cout << yellow("Logged out successfully.") << endl;
         pressEnter();
     }
@@ -370,25 +3442,29 @@ public:
                 return;
             }
         }
-        users.emplace_back(username, password, role);
+        users.emplace(username, password, role);
         saveUsersToCSV(); // Auto-save
         cout << green("User '") << username << green("' added successfully.") << endl;
     }
 
     void deleteUser(const string &username)
     {
-        if (currentUser && currentUser->username == username)
+        const User *loggedIn = users.get(currentUser);
+        if (loggedIn && loggedIn->username == username)
         {
             cout << red("Cannot delete the currently logged-in user.") << endl;
             return;
         }
 
-        auto it = remove_if(users.begin(), users.end(), [&](const User &user)
-                            { return user.username == username; });
+        SlotMap<User>::Handle target;
+        for (size_t i = 0; i < users.size() && target.isNull(); i++)
+        {
+            if (users.get(users.handleAt(i))->username == username)
+                target = users.handleAt(i);
+        }
 
-        if (it != users.end())
+        if (users.erase(target))
         {
-            users.erase(it, users.end());
             saveUsersToCSV(); // Auto-save
             cout << green("User '") << username << green("' deleted successfully.") << endl;
         }
@@ -525,11 +3601,14 @@ class EmployeeManagement
 {
 private:
     vector<Employee> &employees; // Reference to the main employees vector
+    EmployeeIndex &employeeIndex; // Reference to the shared ID -> slot index
     int &nextEmployeeId;         // Reference to the global ID counter
+    ChangeJournal &journal;      // Reference to the shared change journal
+    mutex &dataMutex;            // Held only while changing the data, never during a prompt
 
 public:
-    EmployeeManagement(vector<Employee> &allEmployees, int &idCounter)
-        : employees(allEmployees), nextEmployeeId(idCounter) {}
+    EmployeeManagement(vector<Employee> &allEmployees, EmployeeIndex &index, int &idCounter, ChangeJournal &changeJournal, mutex &dataLock)
+        : employees(allEmployees), employeeIndex(index), nextEmployeeId(idCounter), journal(changeJournal), dataMutex(dataLock) {}
 
     void addEmployee(User *currentUser)
     {
@@ -539,7 +3618,7 @@ public:
             return;
         }
         string name, department, position;
-        double salary;
+        Money salary;
         cout << "Enter Name: ";
         cin.ignore(); // Clear buffer
         getline(cin, name);
@@ -550,8 +3629,15 @@ public:
         cout << "Enter Salary/M : ";
         cin >> salary;
 
-        employees.emplace_back(nextEmployeeId++, name, department, position, salary);
-        cout << green("Employee added successfully. ID: ") << employees.back().id << endl;
+        int id;
+        {
+            lock_guard<mutex> lock(dataMutex);
+            id = nextEmployeeId++;
+            employees.emplace_back(id, name, department, position, salary);
+            employeeIndex.added();
+            journal.employeeUpserted(employees.back());
+        }
+        cout << green("Employee added successfully. ID: ") << id << endl;
     }
 
     void updateEmployeeDetails(User *currentUser)
@@ -565,36 +3651,41 @@ public:
         cout << blue("Enter employee ID to update: ");
         cin >> id;
 
-        for (Employee &emp : employees)
+        if (Employee *found = employeeIndex.find(id))
         {
-            if (emp.id == id)
-            {
-                cout << blue("Enter new Name (or 'nochange'): ");
-                string newValue;
-                cin.ignore();
-                getline(cin, newValue);
-                if (newValue != "nochange")
-                    emp.name = newValue;
+            // Edits go to a copy, so the saver never sees a half-updated record
+            Employee updated = *found;
+            cout << blue("Enter new Name (or 'nochange'): ");
+            string newValue;
+            cin.ignore();
+            getline(cin, newValue);
+            if (newValue != "nochange")
+                updated.name = newValue;
+
+            cout << blue("Enter new Department (or 'nochange'): ");
+            getline(cin, newValue);
+            if (newValue != "nochange")
+                updated.department = newValue;
+
+            cout << blue("Enter new Position (or 'nochange'): ");
+            getline(cin, newValue);
+            if (newValue != "nochange")
+                updated.position = newValue;
+
+            cout << blue("Enter new Salary (or '0' for nochange'): ");
+            Money newSalary;
+            cin >> newSalary;
+            if (newSalary != Money())
+                updated.salary = newSalary;
 
-                cout << blue("Enter new Department (or 'nochange'): ");
-                getline(cin, newValue);
-                if (newValue != "nochange")
-                    emp.department = newValue;
-
-                cout << blue("Enter new Position (or 'nochange'): ");
-                getline(cin, newValue);
-                if (newValue != "nochange")
-                    emp.position = newValue;
-
-                cout << blue("Enter new Salary (or '0' for nochange'): ");
-                double newSalary;
-                cin >> newSalary;
-                if (newSalary != 0)
-                    emp.salary = newSalary;
-
-                cout << green("Employee details updated successfully.") << endl;
-                return;
+            {
+                lock_guard<mutex> lock(dataMutex);
+                *found = move(updated);
+                employeeIndex.changed(*found);
+                journal.employeeUpserted(*found);
             }
+            cout << green("Employee details updated successfully.") << endl;
+            return;
         }
         cout << red("Employee not found.") << endl;
     }
@@ -610,12 +3701,15 @@ public:
         cout << blue("Enter employee ID to delete: ");
         cin >> id;
 
-        auto it = remove_if(employees.begin(), employees.end(), [id](const Employee &emp)
-                            { return emp.id == id; });
-
-        if (it != employees.end())
+        bool removed;
+        {
+            lock_guard<mutex> lock(dataMutex);
+            removed = employeeIndex.remove(id);
+            if (removed)
+                journal.employeeDeleted(id);
+        }
+        if (removed)
         {
-            employees.erase(it, employees.end());
             cout << green("Employee record deleted successfully.") << endl;
         }
         else
@@ -635,17 +3729,20 @@ public:
         cout << blue("Enter employee ID to set hiring status: ");
         cin >> id;
 
-        for (Employee &emp : employees)
+        if (Employee *found = employeeIndex.find(id))
         {
-            if (emp.id == id)
+            Employee &emp = *found;
+            cout << blue("Enter new hiring status (e.g., Applied, Hired, Active): ");
+            string status;
+            cin >> status;
             {
-                cout << blue("Enter new hiring status (e.g., Applied, Hired, Active): ");
-                string status;
-                cin >> status;
+                lock_guard<mutex> lock(dataMutex);
                 emp.hiringStatus = status;
-                cout << green("Hiring status updated successfully.") << endl;
-                return;
+                employeeIndex.changed(emp);
+                journal.employeeUpserted(emp);
             }
+            cout << green("Hiring status updated successfully.") << endl;
+            return;
         }
         cout << red("Employee not found.") << endl;
     }
@@ -658,21 +3755,107 @@ public:
             return;
         }
         cout << blue("\nAll Employees:") << endl;
-        if (employees.empty())
+        if (employeeIndex.liveCount() == 0)
         {
             cout << red("No employees in the system.") << endl;
             return;
         }
 
-        Table table;
-        table.add_row({"ID", "Name", "Department", "Position", "Salary", "Status"});
-        table[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
+        vector<uint32_t> order = employeeIndex.liveSlots();
+        EmployeePager(employees, order).run();
+    }
 
-        for (const auto &emp : employees)
+    void filterEmployees(User *currentUser)
+    {
+        if (!currentUser || !currentUser->canView())
         {
-            table.add_row({to_string(emp.id), emp.name, emp.department, emp.position, to_string_with_precision(emp.salary), emp.hiringStatus});
+            cout << red("Permission denied.") << endl;
+            return;
+        }
+        cout << yellow("Example: department=Sales and salary>4000 and status=Active and project=12") << endl;
+        cout << blue("Enter filter: ");
+        string query;
+        cin.ignore(); // Clear buffer
+        getline(cin, query);
+
+        EmployeeFilter filter;
+        try
+        {
+            filter = EmployeeFilter::parse(query);
+        }
+        catch (const std::exception &e)
+        {
+            cout << red("Invalid filter: ") << e.what() << endl;
+            return;
+        }
+
+        string plan;
+        vector<const Employee *> matches = filter.run(employees, employeeIndex, plan);
+        cout << blue("Plan: ") << plan << endl;
+        if (matches.empty())
+        {
+            cout << red("No employees match the filter.") << endl;
+            return;
+        }
+
+        TextTable table({"ID", "Name", "Department", "Position", "Salary", "Status"});
+        for (const Employee *emp : matches)
+        {
+            table.addRow({to_string(emp->id), emp->name, emp->department.str(), emp->position.str(), emp->salary.toString(), emp->hiringStatus.str()});
+        }
+        printTable(table);
+        cout << green("Matched ") << matches.size() << green(" employee(s).") << endl;
+
+        cout << blue("Export results to Excel? (y/n): ");
+        char exportChar;
+        cin >> exportChar;
+        if (exportChar == 'y' || exportChar == 'Y')
+        {
+            cout << blue("Enter file name (e.g. filtered.xlsx): ");
+            string filePath;
+            cin >> filePath;
+            exportEmployeesToExcel(matches, filePath);
+        }
+    }
+
+    void exportEmployeesToExcel(const vector<const Employee *> &selection, const string &filePath)
+    {
+        xlnt::workbook wb;
+        xlnt::worksheet ws = wb.active_sheet();
+        ws.title("Employees");
+
+        ws.cell("A1").value("ID");
+        ws.cell("B1").value("Name");
+        ws.cell("C1").value("Department");
+        ws.cell("D1").value("Position");
+        ws.cell("E1").value("Salary");
+        ws.cell("F1").value("Status");
+        ws.cell("G1").value("Client ID");
+        ws.cell("H1").value("Project ID");
+
+        int row = 2;
+        for (const Employee *emp : selection)
+        {
+            ws.cell("A" + to_string(row)).value(emp->id);
+            ws.cell("B" + to_string(row)).value(emp->name);
+            ws.cell("C" + to_string(row)).value(emp->department.str());
+            ws.cell("D" + to_string(row)).value(emp->position.str());
+            ws.cell("E" + to_string(row)).value(emp->salary.toDouble());
+            ws.cell("F" + to_string(row)).value(emp->hiringStatus.str());
+            ws.cell("G" + to_string(row)).value(emp->assignedClientId);
+            ws.cell("H" + to_string(row)).value(emp->assignedProjectId);
+            ++row;
+        }
+
+        try
+        {
+            wb.save(filePath);
+            cout << green("Employees exported to Excel successfully to: ") << filePath << endl;
+        }
+        catch (const std::exception &e)
+        {
+            cerr << red("Error exporting to Excel: ") << e.what() << endl;
         }
-        cout << table << endl;
     }
 
     void displayOneEmployeeByID(User *currentUser)
@@ -686,16 +3869,62 @@ public:
         cout << blue("Enter employee ID: ");
         cin >> id;
 
-        for (const auto &emp : employees)
+        if (const Employee *found = employeeIndex.find(id))
+        {
+            const Employee &emp = *found;
+            cout << blue("\nEmployee Details:") << endl;
+            emp.display();
+            return;
+        }
+        cout << red("Employee not found.") << endl;
+    }
+
+    // Employees whose ID equals the query or whose name, department or
+    // position contains it, in roster order. Uses the trigram index when the
+    // query is long enough and falls back to a scan otherwise.
+    vector<const Employee *> findEmployees(const string &query, bool ignoreCase) const
+    {
+        const string needle = ignoreCase ? EmployeeSearchIndex::fold(query) : query;
+        auto contains = [&](const string &field)
+        {
+            return (ignoreCase ? EmployeeSearchIndex::fold(field) : field).find(needle) != string::npos;
+        };
+        auto matches = [&](const Employee &emp)
+        {
+            return to_string(emp.id) == query || contains(emp.name) || contains(emp.department) || contains(emp.position);
+        };
+
+        vector<const Employee *> found;
+        if (query.size() < EmployeeSearchIndex::minQueryLength)
         {
-            if (emp.id == id)
+            for (uint32_t slot : employeeIndex.liveSlots())
             {
-                cout << blue("\nEmployee Details:") << endl;
-                emp.display();
-                return;
+                if (matches(employees[slot]))
+                    found.push_back(&employees[slot]);
             }
+            return found;
         }
-        cout << red("Employee not found.") << endl;
+
+        vector<long> slots;
+        for (int id : employeeIndex.text().candidates(query))
+        {
+            const Employee *emp = employeeIndex.find(id);
+            if (emp && matches(*emp))
+                slots.push_back(employeeIndex.slotOf(id));
+        }
+        // A numeric query can also be an exact ID
+        if (all_of(query.begin(), query.end(), [](unsigned char ch)
+                   { return isdigit(ch); }) &&
+            query.size() < 10)
+        {
+            long slot = employeeIndex.slotOf(stoi(query));
+            if (slot >= 0 && find(slots.begin(), slots.end(), slot) == slots.end())
+                slots.push_back(slot);
+        }
+        sort(slots.begin(), slots.end());
+        for (long slot : slots)
+            found.push_back(&employees[slot]);
+        return found;
     }
 
     void searchEmployees(User *currentUser)
@@ -705,25 +3934,22 @@ public:
             cout << red("Permission denied.") << endl;
             return;
         }
-        cout << blue("Search by Name, ID, or Department: ");
+        cout << blue("Search by Name, ID, Department, or Position: ");
         string query;
         cin.ignore(); // Clear buffer
         getline(cin, query);
+        cout << blue("Ignore upper/lower case? (y/n): ");
+        char caseChar;
+        cin >> caseChar;
+        bool ignoreCase = (caseChar == 'y' || caseChar == 'Y');
 
-        Table results;
-        results.add_row({"ID", "Name", "Department", "Position", "Status"});
-        results[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
+        TextTable results({"ID", "Name", "Department", "Position", "Status"});
 
         bool found = false;
-        for (const auto &emp : employees)
+        for (const Employee *emp : findEmployees(query, ignoreCase))
         {
-            if (emp.name.find(query) != string::npos ||
-                to_string(emp.id) == query ||
-                emp.department.find(query) != string::npos)
-            {
-                results.add_row({to_string(emp.id), emp.name, emp.department, emp.position, emp.hiringStatus});
-                found = true;
-            }
+            results.addRow({to_string(emp->id), emp->name, emp->department.str(), emp->position.str(), emp->hiringStatus.str()});
+            found = true;
         }
 
         if (!found)
@@ -732,7 +3958,7 @@ public:
         }
         else
         {
-            cout << results << endl;
+            printTable(results);
         }
     }
 };
@@ -742,9 +3968,13 @@ class ResourceManagement
 {
 private:
     vector<Employee> &employees; // Reference to the main employees vector
+    EmployeeIndex &employeeIndex; // Reference to the shared ID -> slot index
+    ChangeJournal &journal;      // Reference to the shared change journal
+    mutex &dataMutex;            // Held only while changing the data, never during a prompt
 
 public:
-    ResourceManagement(vector<Employee> &allEmployees) : employees(allEmployees) {}
+    ResourceManagement(vector<Employee> &allEmployees, EmployeeIndex &index, ChangeJournal &changeJournal, mutex &dataLock)
+        : employees(allEmployees), employeeIndex(index), journal(changeJournal), dataMutex(dataLock) {}
 
     void assignEmployeeToDepartment(User *currentUser)
     {
@@ -761,14 +3991,17 @@ public:
         cin.ignore();
         getline(cin, newDept);
 
-        for (Employee &emp : employees)
+        if (Employee *found = employeeIndex.find(empId))
         {
-            if (emp.id == empId)
+            Employee &emp = *found;
             {
+                lock_guard<mutex> lock(dataMutex);
                 emp.department = newDept;
-                cout << green("Employee ") << emp.name << green(" assigned to ") << newDept << green(" successfully.") << endl;
-                return;
+                employeeIndex.changed(emp);
+                journal.employeeUpserted(emp);
             }
+            cout << green("Employee ") << emp.name << green(" assigned to ") << newDept << green(" successfully.") << endl;
+            return;
         }
         cout << red("Employee not found.") << endl;
     }
@@ -780,19 +4013,15 @@ public:
             cout << red("Permission denied.") << endl;
             return;
         }
-        map<string, int> departmentCounts;
-        for (const auto &emp : employees)
-        {
-            departmentCounts[emp.department]++;
-        }
+        vector<int> departmentCounts = employeeIndex.departments().counts();
 
         Table table;
         table.add_row({"Department", "Number of Employees"});
         table[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
 
-        for (const auto &pair : departmentCounts)
+        for (uint32_t code : usedCodesByValue<FIELD_DEPARTMENT>(departmentCounts))
         {
-            table.add_row({pair.first, to_string(pair.second)});
+            table.add_row({Department::dictionary().value(code), to_string(departmentCounts[code])});
         }
         cout << table << endl;
     }
@@ -812,14 +4041,17 @@ public:
         cin.ignore();
         getline(cin, newDept);
 
-        for (Employee &emp : employees)
+        if (Employee *found = employeeIndex.find(empId))
         {
-            if (emp.id == empId)
+            Employee &emp = *found;
             {
+                lock_guard<mutex> lock(dataMutex);
                 emp.department = newDept;
-                cout << green("Employee ") << emp.name << green(" reassigned to ") << newDept << green(" successfully.") << endl;
-                return;
+                employeeIndex.changed(emp);
+                journal.employeeUpserted(emp);
             }
+            cout << green("Employee ") << emp.name << green(" reassigned to ") << newDept << green(" successfully.") << endl;
+            return;
         }
         cout << red("Employee not found.") << endl;
     }
@@ -831,19 +4063,19 @@ public:
             cout << red("Permission denied.") << endl;
             return;
         }
-        map<string, int> positionCounts;
-        for (const auto &emp : employees)
+        vector<int> positionCounts(Position::dictionary().size(), 0);
+        for (uint32_t slot : employeeIndex.liveSlots())
         {
-            positionCounts[emp.position]++;
+            positionCounts[employees[slot].position.code()]++;
         }
 
         Table table;
         table.add_row({"Position", "Number of Employees"});
         table[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
 
-        for (const auto &pair : positionCounts)
+        for (uint32_t code : usedCodesByValue<FIELD_POSITION>(positionCounts))
         {
-            table.add_row({pair.first, to_string(pair.second)});
+            table.add_row({Position::dictionary().value(code), to_string(positionCounts[code])});
         }
         cout << table << endl;
     }
@@ -854,9 +4086,13 @@ class TimeManagement
 {
 private:
     vector<Employee> &employees; // Reference to the main employees vector
+    EmployeeIndex &employeeIndex; // Reference to the shared ID -> slot index
+    ChangeJournal &journal;      // Reference to the shared change journal
+    mutex &dataMutex;            // Held only while changing the data, never during a prompt
 
 public:
-    TimeManagement(vector<Employee> &allEmployees) : employees(allEmployees) {}
+    TimeManagement(vector<Employee> &allEmployees, EmployeeIndex &index, ChangeJournal &changeJournal, mutex &dataLock)
+        : employees(allEmployees), employeeIndex(index), journal(changeJournal), dataMutex(dataLock) {}
 
     void recordEmployeeAttendance(User *currentUser)
     {
@@ -873,24 +4109,33 @@ public:
         cout << blue("Enter employee ID: ");
         cin >> empId;
 
-        for (Employee &emp : employees)
-        {
-            if (emp.id == empId)
-            {
-                cout << blue("Enter date (YYYY MM DD):\n ");
-                cout << blue(">> YYYY: ");
-                cin >> year;
-                cout << blue(">> MM: ");
-                cin >> month;
-                cout << blue(">> DD: ");
-                cin >> day;
-                cout << blue("Is employee present? (y/n): ");
-                cin >> presentChar;
-                present = (presentChar == 'y' || presentChar == 'Y');
-                emp.attendance[{year, month, day}] = present;
-                cout << green("Attendance recorded for ") << emp.name << green(" on ") << Date{year, month, day}.toString() << green(": ") << (present ? green("Present") : "Absent") << endl;
+        if (Employee *found = employeeIndex.find(empId))
+        {
+            Employee &emp = *found;
+            cout << blue("Enter date (YYYY MM DD):\n ");
+            cout << blue(">> YYYY: ");
+            cin >> year;
+            cout << blue(">> MM: ");
+            cin >> month;
+            cout << blue(">> DD: ");
+            cin >> day;
+            cout << blue("Is employee present? (y/n): ");
+            cin >> presentChar;
+            present = (presentChar == 'y' || presentChar == 'Y');
+            Date date{year, month, day};
+            if (!date.isValid())
+            {
+                cout << red("Invalid date.") << endl;
                 return;
             }
+            {
+                lock_guard<mutex> lock(dataMutex);
+                emp.attendance.set(date, present);
+                employeeIndex.attendanceRecorded(emp, date, present);
+                journal.attendanceRecorded(emp.id, date, present);
+            }
+            cout << green("Attendance recorded for ") << emp.name << green(" on ") << date.toString() << green(": ") << (present ? green("Present") : "Absent") << endl;
+            return;
         }
         cout << red("Employee not found.") << endl;
     }
@@ -909,14 +4154,17 @@ public:
         cout << blue("Enter hours worked/assigned for a shift: ");
         cin >> hours;
 
-        for (Employee &emp : employees)
+        if (Employee *found = employeeIndex.find(empId))
         {
-            if (emp.id == empId)
+            Employee &emp = *found;
             {
+                lock_guard<mutex> lock(dataMutex);
                 emp.hoursWorked += hours;
-                cout << blue("Work hours updated for ") << emp.name << blue(". Total: ") << emp.hoursWorked << endl;
-                return;
+                employeeIndex.changed(emp);
+                journal.employeeUpserted(emp);
             }
+            cout << blue("Work hours updated for ") << emp.name << blue(". Total: ") << emp.hoursWorked << endl;
+            return;
         }
         cout << red("Employee not found.") << endl;
     }
@@ -938,27 +4186,189 @@ public:
         cout << blue("Enter number of days: ");
         cin >> days;
 
-        for (Employee &emp : employees)
+        if (Employee *found = employeeIndex.find(empId))
         {
-            if (emp.id == empId)
+            Employee &emp = *found;
+            double *balance = leaveType == "vacation" ? &emp.vacationDays
+                              : leaveType == "sick"   ? &emp.sickDays
+                              : leaveType == "other"  ? &emp.otherLeaveDays
+                                                      : nullptr;
+            if (!balance)
             {
-                if (leaveType == "vacation")
-                    emp.vacationDays += days;
-                else if (leaveType == "sick")
-                    emp.sickDays += days;
-                else if (leaveType == "other")
-                    emp.otherLeaveDays += days;
-                else
-                {
-                    cout << red("Invalid leave type.") << endl;
-                    return;
-                }
-                cout << blue("Leave balance updated for ") << emp.name << blue(". ") << leaveType << blue(" days: ") << days << endl;
+                cout << red("Invalid leave type.") << endl;
                 return;
             }
+            {
+                lock_guard<mutex> lock(dataMutex);
+                *balance += days;
+                employeeIndex.changed(emp);
+                journal.employeeUpserted(emp);
+            }
+            cout << blue("Leave balance updated for ") << emp.name << blue(". ") << leaveType << blue(" days: ") << days << endl;
+            return;
         }
         cout << red("Employee not found.") << endl;
     }
+
+    // Attendance rates per employee, per department and company-wide over a
+    // date range, with each employee's longest absence streak. Employees
+    // are evaluated in parallel; each one costs a few popcounts per year.
+    void attendanceRatesReport(User *currentUser)
+    {
+        if (!currentUser || !currentUser->canView())
+        {
+            cout << red("Permission denied.") << endl;
+            return;
+        }
+        Date from, to;
+        cout << blue("Enter start date (YYYY MM DD): ");
+        cin >> from.year >> from.month >> from.day;
+        cout << blue("Enter end date (YYYY MM DD): ");
+        cin >> to.year >> to.month >> to.day;
+        if (!from.isValid() || !to.isValid() || to < from)
+        {
+            cout << red("Invalid date range.") << endl;
+            return;
+        }
+        cout << blue("How many employees to list, lowest rate first (0 for all): ");
+        size_t listCount;
+        cin >> listCount;
+
+        struct EmployeeAttendance
+        {
+            size_t recorded = 0;
+            size_t present = 0;
+            int longestStreak = 0;
+        };
+        vector<EmployeeAttendance> stats(employees.size());
+        parallelFor(employees.size(), [&](size_t begin, size_t end)
+                    {
+            for (size_t i = begin; i < end; i++)
+            {
+                if (!employeeIndex.isLive(i))
+                    continue;
+                employees[i].attendance.count(from, to, stats[i].recorded, stats[i].present);
+                if (stats[i].recorded > stats[i].present)
+                    stats[i].longestStreak = employees[i].attendance.longestAbsenceStreak(from, to);
+            } }, 1024);
+
+        // Roll up by department code
+        const StringDictionary &departments = Department::dictionary();
+        vector<int> departmentEmployees(departments.size(), 0);
+        vector<size_t> departmentRecorded(departments.size(), 0), departmentPresent(departments.size(), 0);
+        size_t totalRecorded = 0, totalPresent = 0;
+        vector<size_t> withRecords;
+        for (size_t i = 0; i < employees.size(); i++)
+        {
+            if (stats[i].recorded == 0)
+                continue;
+            uint32_t code = employees[i].department.code();
+            departmentEmployees[code]++;
+            departmentRecorded[code] += stats[i].recorded;
+            departmentPresent[code] += stats[i].present;
+            totalRecorded += stats[i].recorded;
+            totalPresent += stats[i].present;
+            withRecords.push_back(i);
+        }
+        if (totalRecorded == 0)
+        {
+            cout << red("No attendance recorded between ") << from.toString() << red(" and ") << to.toString() << endl;
+            return;
+        }
+
+        auto rate = [](size_t present, size_t recorded)
+        {
+            return to_string_with_precision(100.0 * present / recorded, 1) + "%";
+        };
+
+        cout << blue("\nCompany-wide attendance: ") << rate(totalPresent, totalRecorded)
+             << blue(" (") << totalPresent << blue(" of ") << totalRecorded << blue(" recorded days)") << endl;
+
+        Table byDepartment;
+        byDepartment.add_row({"Department", "Employees", "Recorded Days", "Present Days", "Attendance Rate"});
+        byDepartment[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
+        for (uint32_t code : usedCodesByValue<FIELD_DEPARTMENT>(departmentEmployees))
+        {
+            byDepartment.add_row({departments.value(code), to_string(departmentEmployees[code]), to_string(departmentRecorded[code]),
+                                  to_string(departmentPresent[code]), rate(departmentPresent[code], departmentRecorded[code])});
+        }
+        cout << blue("\nBy Department:") << endl;
+        cout << byDepartment << endl;
+
+        // Lowest rate first, longest streak breaking ties
+        sort(withRecords.begin(), withRecords.end(), [&](size_t a, size_t b)
+             {
+            double rateA = double(stats[a].present) / stats[a].recorded, rateB = double(stats[b].present) / stats[b].recorded;
+            if (rateA != rateB)
+                return rateA < rateB;
+            return stats[a].longestStreak > stats[b].longestStreak; });
+        if (listCount == 0 || listCount > withRecords.size())
+            listCount = withRecords.size();
+
+        TextTable byEmployee({"ID", "Name", "Department", "Recorded Days", "Attendance Rate", "Longest Absence Streak"});
+        for (size_t k = 0; k < listCount; k++)
+        {
+            size_t i = withRecords[k];
+            const Employee &emp = employees[i];
+            byEmployee.addRow({to_string(emp.id), emp.name, emp.department.str(), to_string(stats[i].recorded),
+                               rate(stats[i].present, stats[i].recorded), to_string(stats[i].longestStreak)});
+        }
+        cout << blue("\nBy Employee:") << endl;
+        printTable(byEmployee);
+    }
+
+    // Daily headcounts and absentees over a date range, read from the
+    // date-major attendance index
+    void attendanceReportByDate(User *currentUser)
+    {
+        if (!currentUser || !currentUser->canView())
+        {
+            cout << red("Permission denied.") << endl;
+            return;
+        }
+        Date from, to;
+        cout << blue("Enter start date (YYYY MM DD): ");
+        cin >> from.year >> from.month >> from.day;
+        cout << blue("Enter end date (YYYY MM DD): ");
+        cin >> to.year >> to.month >> to.day;
+        if (!from.isValid() || !to.isValid() || to < from)
+        {
+            cout << red("Invalid date range.") << endl;
+            return;
+        }
+
+        const AttendanceByDate &byDate = employeeIndex.attendance();
+        vector<AttendanceByDate::DayCount> counts = byDate.headcounts(from, to);
+        if (counts.empty())
+        {
+            cout << red("No attendance recorded between ") << from.toString() << red(" and ") << to.toString() << endl;
+            return;
+        }
+
+        TextTable daily({"Date", "Present", "Absent"});
+        for (const auto &day : counts)
+        {
+            daily.addRow({day.date.toString(), to_string(day.present), to_string(day.absent)});
+        }
+        cout << blue("\nDaily Headcount:") << endl;
+        printTable(daily);
+
+        vector<pair<int, int>> absences = byDate.absences(from, to);
+        if (absences.empty())
+        {
+            cout << green("Nobody was absent in this period.") << endl;
+            return;
+        }
+
+        TextTable absentees({"ID", "Name", "Department", "Days Absent"});
+        for (const auto &absence : absences)
+        {
+            if (const Employee *emp = employeeIndex.find(absence.first))
+                absentees.addRow({to_string(emp->id), emp->name, emp->department.str(), to_string(absence.second)});
+        }
+        cout << blue("\nAbsentees:") << endl;
+        printTable(absentees);
+    }
 };
 
 // 5. Client Relationship Management
@@ -967,15 +4377,23 @@ class ClientRelationshipManagement
 private:
     std::vector<Client> &clients;
     std::vector<Employee> &employees;
+    EmployeeIndex &employeeIndex;
     std::vector<Project> &projects;
+    ProjectIndex &projectIndex;
     int &nextClientId;
+    ChangeJournal &journal;
+    std::mutex &dataMutex; // Held only while changing the data, never during a prompt
 
 public:
     ClientRelationshipManagement(std::vector<Client> &allClients,
                                  std::vector<Employee> &allEmployees,
+                                 EmployeeIndex &index,
                                  std::vector<Project> &allProjects,
-                                 int &idCounter)
-        : clients(allClients), employees(allEmployees), projects(allProjects), nextClientId(idCounter) {}
+                                 ProjectIndex &projIndex,
+                                 int &idCounter,
+                                 ChangeJournal &changeJournal,
+                                 std::mutex &dataLock)
+        : clients(allClients), employees(allEmployees), employeeIndex(index), projects(allProjects), projectIndex(projIndex), nextClientId(idCounter), journal(changeJournal), dataMutex(dataLock) {}
 
     void addClientRecord(User *currentUser)
     {
@@ -994,8 +4412,14 @@ public:
         std::cout << blue("Enter Contact Email: ");
         std::getline(std::cin, contactEmail);
 
-        clients.emplace_back(nextClientId++, name, contactPerson, contactEmail);
-        std::cout << green("Client record added successfully. ID: ") << clients.back().id << std::endl;
+        int id;
+        {
+            std::lock_guard<std::mutex> lock(dataMutex);
+            id = nextClientId++;
+            clients.emplace_back(id, name, contactPerson, contactEmail);
+            journal.clientUpserted(clients.back());
+        }
+        std::cout << green("Client record added successfully. ID: ") << id << std::endl;
     }
 
     void assignEmployeesToClientsAccounts(User *currentUser)
@@ -1013,14 +4437,16 @@ public:
         std::cin >> clientId;
 
         bool empFound = false, clientFound = false;
-        for (auto &emp : employees)
+        if (Employee *found = employeeIndex.find(empId))
         {
-            if (emp.id == empId)
+            Employee &emp = *found;
             {
+                std::lock_guard<std::mutex> lock(dataMutex);
                 emp.assignedClientId = clientId;
-                empFound = true;
-                break;
+                employeeIndex.changed(emp);
+                journal.employeeUpserted(emp);
             }
+            empFound = true;
         }
 
         for (const auto &client : clients)
@@ -1052,25 +4478,23 @@ public:
             return;
         }
 
-        Table table;
-
-        table.add_row({"Client ID", "Client Name", "Contact Person", "Contact Email"});
-        table[0].format().font_style({FontStyle::bold}).font_align(FontAlign::center).font_color(Color::cyan).border_bottom("─");
+        TextTable table({"Client ID", "Client Name", "Contact Person", "Contact Email"});
 
         for (const auto &c : clients)
         {
-            table.add_row({std::to_string(c.id),
-                           c.name,
-                           c.contactPerson,
-                           c.contactEmail});
+            table.addRow({std::to_string(c.id),
+                          c.name,
+                          c.contactPerson,
+                          c.contactEmail});
         }
 
-        for (size_t i = 1; i < table.size(); ++i)
-        {
-            table[i].format().font_align(FontAlign::center);
-        }
-
-        std::cout << table << std::endl;
+        printTable(table, [](Table &small)
+                   {
+            small[0].format().font_style({FontStyle::bold}).font_align(FontAlign::center).font_color(Color::cyan).border_bottom("─");
+            for (size_t i = 1; i < small.size(); ++i)
+            {
+                small[i].format().font_align(FontAlign::center);
+            } });
     }
 
     void trackClientSpecificProjectsOrContacts(User *currentUser)
@@ -1105,18 +4529,14 @@ public:
 
         std::cout << blue("\nProjects for Client ") << clientId << ":\n";
 
-        Table projects_table;
-        projects_table.add_row({"Project ID", "Name", "Deadline", "Description"});
-        projects_table[0].format().font_style({FontStyle::bold});
+        TextTable projects_table({"Project ID", "Name", "Deadline", "Description"});
 
         bool hasProjects = false;
-        for (const auto &proj : projects)
+        for (size_t slot : projectIndex.forClient(clientId))
         {
-            if (proj.clientId == clientId)
-            {
-                projects_table.add_row({to_string(proj.id), proj.name, proj.deadline.toString(), proj.description});
-                hasProjects = true;
-            }
+            const Project &proj = projects[slot];
+            projects_table.addRow({to_string(proj.id), proj.name, proj.deadline.toString(), proj.description});
+            hasProjects = true;
         }
 
         if (!hasProjects)
@@ -1125,7 +4545,8 @@ public:
         }
         else
         {
-            cout << projects_table << endl;
+            printTable(projects_table, [](Table &small)
+                       { small[0].format().font_style({FontStyle::bold}); });
         }
     }
 
@@ -1168,12 +4589,16 @@ class ProjectManagement
 private:
     vector<Project> &projects;   // Reference to the main projects vector
     vector<Employee> &employees; // Reference to the main employees vector
+    EmployeeIndex &employeeIndex; // Reference to the shared ID -> slot index
+    ProjectIndex &projectIndex;   // Reference to the shared project index
     vector<Client> &clients;     // Reference to the main clients vector
     int &nextProjectId;          // Reference to the global project ID counter
+    ChangeJournal &journal;      // Reference to the shared change journal
+    mutex &dataMutex;            // Held only while changing the data, never during a prompt
 
 public:
-    ProjectManagement(vector<Project> &allProjects, vector<Employee> &allEmployees, vector<Client> &allClients, int &idCounter)
-        : projects(allProjects), employees(allEmployees), clients(allClients), nextProjectId(idCounter) {}
+    ProjectManagement(vector<Project> &allProjects, vector<Employee> &allEmployees, EmployeeIndex &index, ProjectIndex &projIndex, vector<Client> &allClients, int &idCounter, ChangeJournal &changeJournal, mutex &dataLock)
+        : projects(allProjects), employees(allEmployees), employeeIndex(index), projectIndex(projIndex), clients(allClients), nextProjectId(idCounter), journal(changeJournal), dataMutex(dataLock) {}
 
     void createProject(User *currentUser)
     {
@@ -1217,8 +4642,15 @@ public:
             return;
         }
 
-        projects.emplace_back(nextProjectId++, name, description, Date{year, month, day}, clientId);
-        cout << green("Project created successfully. ID: ") << projects.back().id << endl;
+        int id;
+        {
+            lock_guard<mutex> lock(dataMutex);
+            id = nextProjectId++;
+            projects.emplace_back(id, name, description, Date{year, month, day}, clientId);
+            projectIndex.added();
+            journal.projectUpserted(projects.back());
+        }
+        cout << green("Project created successfully. ID: ") << id << endl;
     }
 
     void assignEmployeesToProjects(User *currentUser)
@@ -1237,24 +4669,19 @@ public:
         bool empFound = false;
         bool projFound = false;
 
-        for (Employee &emp : employees)
+        if (Employee *found = employeeIndex.find(empId))
         {
-            if (emp.id == empId)
+            Employee &emp = *found;
             {
+                lock_guard<mutex> lock(dataMutex);
                 emp.assignedProjectId = projId;
-                empFound = true;
-                break;
+                employeeIndex.changed(emp);
+                journal.employeeUpserted(emp);
             }
+            empFound = true;
         }
 
-        for (const Project &proj : projects)
-        {
-            if (proj.id == projId)
-            {
-                projFound = true;
-                break;
-            }
-        }
+        projFound = projectIndex.find(projId) != nullptr;
 
         if (empFound && projFound)
         {
@@ -1274,21 +4701,22 @@ public:
             return;
         }
         cout << blue("\nProject Deadlines:") << endl;
-        if (projects.empty())
+        if (projectIndex.liveCount() == 0)
         {
             cout << red("No projects to display deadlines for.") << endl;
             return;
         }
 
-        Table table;
-        table.add_row({"Project ID", "Name", "Deadline", "Description"});
-        table[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
+        TextTable table({"Project ID", "Name", "Deadline", "Description"});
 
-        for (const auto &proj : projects)
+        for (size_t slot = 0; slot < projects.size(); slot++)
         {
-            table.add_row({to_string(proj.id), proj.name, proj.deadline.toString(), proj.description});
+            if (!projectIndex.isLive(slot))
+                continue;
+            const Project &proj = projects[slot];
+            table.addRow({to_string(proj.id), proj.name, proj.deadline.toString(), proj.description});
         }
-        cout << table << endl;
+        printTable(table);
     }
 
     void viewEmployeesAssignedToProjects(User *currentUser)
@@ -1302,43 +4730,32 @@ public:
         cout << blue("Enter Project ID to view assigned employees: ");
         cin >> projId;
 
-        bool projectFound = false;
-        for (const auto &proj : projects)
+        if (const Project *found = projectIndex.find(projId))
         {
-            if (proj.id == projId)
-            {
-                projectFound = true;
-                cout << blue("\nEmployees assigned to Project ") << proj.name << blue(" (ID: " << proj.id << "):") << endl;
+            const Project &proj = *found;
+            cout << blue("\nEmployees assigned to Project ") << proj.name << blue(" (ID: " << proj.id << "):") << endl;
 
-                Table table;
-                table.add_row({"ID", "Name", "Department", "Position", "Status"});
-                table[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
-                bool assignedFound = false;
+            TextTable table({"ID", "Name", "Department", "Position", "Status"});
+            bool assignedFound = false;
 
-                for (const auto &emp : employees)
-                {
-                    if (emp.assignedProjectId == projId)
-                    {
-                        table.add_row({to_string(emp.id), emp.name, emp.department, emp.position, emp.hiringStatus});
-                        assignedFound = true;
-                    }
-                }
+            for (size_t slot : employeeIndex.slotsOf(employeeIndex.onProject(projId)))
+            {
+                const Employee &emp = employees[slot];
+                table.addRow({to_string(emp.id), emp.name, emp.department.str(), emp.position.str(), emp.hiringStatus.str()});
+                assignedFound = true;
+            }
 
-                if (!assignedFound)
-                {
-                    cout << red("No employees assigned to this project.") << endl;
-                }
-                else
-                {
-                    cout << table << endl;
-                }
-                return;
+            if (!assignedFound)
+            {
+                cout << red("No employees assigned to this project.") << endl;
             }
+            else
+            {
+                printTable(table);
+            }
+            return;
         }
-        if (!projectFound)
-        {
-            cout << red("Project not found.") << endl;
-        }
+        cout << red("Project not found.") << endl;
     }
 
     void deleteProject(User *currentUser)
@@ -1353,20 +4770,18 @@ public:
         cout << blue("Enter project ID to delete: ");
         cin >> projId;
 
-        auto it = remove_if(projects.begin(), projects.end(), [projId](const Project &proj)
-                            { return proj.id == projId; });
-
-        if (it != projects.end())
+        bool removed;
         {
-            projects.erase(it, projects.end());
-
-            for (Employee &emp : employees)
+            lock_guard<mutex> lock(dataMutex);
+            removed = projectIndex.remove(projId);
+            if (removed)
             {
-                if (emp.assignedProjectId == projId)
-                {
-                    emp.assignedProjectId = -1; // Reset to N/A
-                }
+                journal.projectDeleted(projId);        // Replay resets the assignments below as well
+                employeeIndex.unassignProject(projId); // Reset to N/A
             }
+        }
+        if (removed)
+        {
             cout << green("Project " + to_string(projId) + " deleted successfully and all employees have been unassigned.") << endl;
         }
         else
@@ -1381,9 +4796,11 @@ class BusinessIntelligence
 {
 private:
     vector<Employee> &employees; // Reference to the main employees vector
+    EmployeeIndex &employeeIndex; // Reference to the shared ID -> slot index
 
 public:
-    BusinessIntelligence(vector<Employee> &allEmployees) : employees(allEmployees) {}
+    BusinessIntelligence(vector<Employee> &allEmployees, EmployeeIndex &index)
+        : employees(allEmployees), employeeIndex(index) {}
 
     void countTotalEmployees(User *currentUser)
     {
@@ -1392,7 +4809,7 @@ public:
             cout << red("Permission denied.") << endl;
             return;
         }
-        cout << blue("Total Employees: ") << employees.size() << endl;
+        cout << blue("Total Employees: ") << employeeIndex.liveCount() << endl;
     }
 
     void departmentWiseEmployeeStatistics(User *currentUser)
@@ -1402,23 +4819,20 @@ public:
             cout << red("Permission denied.") << endl;
             return;
         }
-        map<string, int> departmentCounts;
-        map<string, double> departmentSalaries;
-
-        for (const auto &emp : employees)
-        {
-            departmentCounts[emp.department]++;
-            departmentSalaries[emp.department] += emp.salary;
-        }
+        const DepartmentAggregates &aggregates = employeeIndex.departments();
+        const StringDictionary &departments = Department::dictionary();
 
         Table table;
-        table.add_row({"Department", "Employee Count", "Average Salary"});
+        table.add_row({"Department", "Employee Count", "Average Salary", "Minimum Salary", "Maximum Salary", "Total Hours"});
         table[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
 
-        for (const auto &pair : departmentCounts)
+        // Listed by department name
+        for (uint32_t code : usedCodesByValue<FIELD_DEPARTMENT>(aggregates.counts()))
         {
-            double avgSalary = (pair.second > 0) ? (departmentSalaries[pair.first] / pair.second) : 0.0;
-            table.add_row({pair.first, to_string(pair.second), to_string_with_precision(avgSalary)});
+            const DepartmentAggregates::Totals &totals = aggregates.of(code);
+            table.add_row({departments.value(code), to_string(totals.count), to_string_with_precision(totals.salarySum.toDouble() / totals.count),
+                           totals.salaries.begin()->toString(), totals.salaries.rbegin()->toString(),
+                           to_string_with_precision(totals.hoursSum, 1)});
         }
         cout << table << endl;
     }
@@ -1430,34 +4844,130 @@ public:
             cout << red("Permission denied.") << endl;
             return;
         }
-        if (employees.empty())
+        if (employeeIndex.liveCount() == 0)
         {
             cout << red("No employees to calculate salary metrics.") << endl;
             return;
         }
 
-        double totalSalary = 0;
-        double minSalary = employees.empty() ? 0 : employees[0].salary;
-        double maxSalary = employees.empty() ? 0 : employees[0].salary;
-
-        for (const auto &emp : employees)
+        // Salary column without tombstoned slots; sorted below
+        const vector<int64_t> &column = employeeIndex.columns().salaryCents;
+        vector<int64_t> sorted;
+        if (employeeIndex.tombstones() == 0)
+        {
+            sorted = column;
+        }
+        else
         {
-            totalSalary += emp.salary;
-            if (emp.salary < minSalary)
-                minSalary = emp.salary;
-            if (emp.salary > maxSalary)
-                maxSalary = emp.salary;
+            sorted.reserve(employeeIndex.liveCount());
+            for (size_t i = 0; i < column.size(); i++)
+            {
+                if (employeeIndex.isLive(i))
+                    sorted.push_back(column[i]);
+            }
         }
 
+        // Exact integer cents: the total is the same however the sum is split
+        Money totalSalary = Money::fromCents(columnSum(sorted));
+
+        cout << blue("Number of histogram bins (0 to skip): ");
+        int bins;
+        cin >> bins;
+
+        parallelSort(sorted);
+        Money minSalary = Money::fromCents(sorted.front());
+        Money maxSalary = Money::fromCents(sorted.back());
+
         Table table;
         table.add_row({"Metric", "Value"});
         table[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
-        table.add_row({"Average Salary", "$" + to_string_with_precision(employees.empty() ? 0 : totalSalary / employees.size())});
-        table.add_row({"Maximum Salary", "$" + to_string_with_precision(maxSalary)});
-        table.add_row({"Minimum Salary", "$" + to_string_with_precision(minSalary)});
+        table.add_row({"Average Salary", "$" + to_string_with_precision(totalSalary.toDouble() / sorted.size())});
+        table.add_row({"Maximum Salary", "$" + maxSalary.toString()});
+        table.add_row({"Minimum Salary", "$" + minSalary.toString()});
+        table.add_row({"Median Salary", "$" + to_string_with_precision(percentile(sorted, 50) / 100)});
+        for (double p : {10.0, 25.0, 75.0, 90.0, 99.0})
+        {
+            table.add_row({"P" + to_string(int(p)) + " Salary", "$" + to_string_with_precision(percentile(sorted, p) / 100)});
+        }
+        cout << table << endl;
+
+        if (bins > 0)
+            printSalaryHistogram(sorted, min(bins, 100));
+        printDepartmentPercentiles();
+    }
+
+    // Equal-width salary bands between the minimum and maximum salary;
+    // `sorted` holds salaries in cents
+    void printSalaryHistogram(const vector<int64_t> &sorted, int bins)
+    {
+        double low = double(sorted.front()), high = double(sorted.back());
+        double width = (high - low) / bins;
+        vector<size_t> counts(bins, 0);
+        if (width <= 0)
+        {
+            counts[0] = sorted.size();
+        }
+        else
+        {
+            // Salaries are sorted, so each band's count is a distance between bounds
+            auto begin = sorted.begin();
+            for (int b = 0; b < bins; b++)
+            {
+                auto end = (b == bins - 1) ? sorted.end() : lower_bound(begin, sorted.end(), low + width * (b + 1));
+                counts[b] = static_cast<size_t>(end - begin);
+                begin = end;
+            }
+        }
+        size_t largest = *max_element(counts.begin(), counts.end());
+
+        Table histogram;
+        histogram.add_row({"Salary Band", "Employees", ""});
+        histogram[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
+        for (int b = 0; b < bins; b++)
+        {
+            string band = "$" + to_string_with_precision((low + width * b) / 100) + " - $" + to_string_with_precision((b == bins - 1 ? high : low + width * (b + 1)) / 100);
+            histogram.add_row({band, to_string(counts[b]), string(largest ? counts[b] * 40 / largest : 0, '#')});
+        }
+        cout << blue("\nSalary Distribution:") << endl;
+        cout << histogram << endl;
+    }
+
+    // Salary percentiles within each department; departments are sorted in parallel
+    void printDepartmentPercentiles()
+    {
+        const EmployeeColumns &cols = employeeIndex.columns();
+        const StringDictionary &departments = Department::dictionary();
+        vector<vector<int64_t>> salariesByCode(departments.size());
+        for (size_t i = 0; i < cols.size(); i++)
+        {
+            if (employeeIndex.isLive(i))
+                salariesByCode[cols.department[i]].push_back(cols.salaryCents[i]);
+        }
+        parallelFor(salariesByCode.size(), [&](size_t first, size_t last)
+                    {
+            for (size_t code = first; code < last; code++)
+                sort(salariesByCode[code].begin(), salariesByCode[code].end()); }, 1);
+
+        vector<int> counts(salariesByCode.size());
+        for (size_t code = 0; code < salariesByCode.size(); code++)
+            counts[code] = static_cast<int>(salariesByCode[code].size());
+
+        Table table;
+        table.add_row({"Department", "Employees", "P10", "P25", "Median", "P75", "P90"});
+        table[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
+        for (uint32_t code : usedCodesByValue<FIELD_DEPARTMENT>(counts))
+        {
+            const vector<int64_t> &sorted = salariesByCode[code];
+            table.add_row({departments.value(code), to_string(sorted.size()),
+                           to_string_with_precision(percentile(sorted, 10) / 100), to_string_with_precision(percentile(sorted, 25) / 100),
+                           to_string_with_precision(percentile(sorted, 50) / 100), to_string_with_precision(percentile(sorted, 75) / 100),
+                           to_string_with_precision(percentile(sorted, 90) / 100)});
+        }
+        cout << blue("\nSalary Percentiles by Department:") << endl;
         cout << table << endl;
     }
 
+    // Shows the roster in a sorted order without reordering or saving it
     void sortEmployees(User *currentUser)
     {
         if (!currentUser || !currentUser->canView())
@@ -1465,36 +4975,34 @@ public:
             cout << red("Permission denied.") << endl;
             return;
         }
-        cout << blue("Sort employees by (name, salary, department): ");
+        cout << yellow("Keys: id, name, department, position, status, salary, hours. Prefix '-' or add 'desc' for descending.") << endl;
+        cout << blue("Sort employees by (e.g. department, -salary): ");
         string sortBy;
-        cin >> sortBy;
+        cin.ignore(); // Clear buffer
+        getline(cin, sortBy);
 
-        if (sortBy == "name")
-        {
-            sort(employees.begin(), employees.end(), [](const Employee &a, const Employee &b)
-                 { return a.name < b.name; });
-        }
-        else if (sortBy == "salary")
-        {
-            sort(employees.begin(), employees.end(), [](const Employee &a, const Employee &b)
-                 { return a.salary < b.salary; });
-        }
-        else if (sortBy == "department")
+        vector<EmployeeOrder::Key> keys;
+        try
         {
-            sort(employees.begin(), employees.end(), [](const Employee &a, const Employee &b)
-                 { return a.department < b.department; });
+            keys = EmployeeOrder::parse(sortBy);
         }
-        else
+        catch (const std::exception &e)
         {
-            cout << red("Invalid sort option.") << endl;
+            cout << red("Invalid sort option: ") << e.what() << endl;
             return;
         }
 
         cout << blue("\nEmployees sorted by ") << sortBy << blue(":") << endl;
-        displayAllEmployees(currentUser);
+        displayEmployees(currentUser, EmployeeOrder::sort(employees, employeeIndex, keys));
     }
 
     void displayAllEmployees(User *currentUser)
+    {
+        displayEmployees(currentUser, employeeIndex.liveSlots());
+    }
+
+    // Shows the employees at the given slots, in that order
+    void displayEmployees(User *currentUser, const vector<uint32_t> &order)
     {
         if (!currentUser || !currentUser->canView())
         {
@@ -1502,21 +5010,397 @@ public:
             return;
         }
         cout << blue("\nAll Employees:") << endl;
-        if (employees.empty())
+        if (order.empty())
         {
             cout << red("No employees in the system.") << endl;
             return;
         }
 
-        Table table;
-        table.add_row({"ID", "Name", "Department", "Position", "Salary", "Status"});
-        table[0].format().font_style({FontStyle::bold}).font_color(Color::yellow);
+        EmployeePager(employees, order).run();
+    }
+};
 
-        for (const auto &emp : employees)
+// 8. Batch Commands
+// Line-oriented commands for headless bulk operations, e.g.
+//
+//     add-employee name="Ann Lee" department=Sales position=Rep salary=4200.50
+//     record-attendance id=12 date=2024-05-01 present=yes
+//
+// Each line is a command followed by key=value arguments; values with
+// spaces go in double quotes. Blank lines and lines starting with # are
+// skipped. Commands change the data the same way the menus do and are
+// journaled like them; the caller saves once at the end.
+class BatchCommands
+{
+private:
+    vector<Employee> &employees;
+    EmployeeIndex &employeeIndex;
+    vector<Client> &clients;
+    vector<Project> &projects;
+    ProjectIndex &projectIndex;
+    int &nextEmployeeId;
+    int &nextClientId;
+    int &nextProjectId;
+    ChangeJournal &journal;
+    mutex &dataMutex; // Held around each command, not while reading the next line
+
+    // Arguments of one command; every argument given must be used
+    class Arguments
+    {
+    private:
+        map<string, string> values;
+        set<string> used;
+
+    public:
+        void add(const string &key, const string &value)
         {
-            table.add_row({to_string(emp.id), emp.name, emp.department, emp.position, to_string_with_precision(emp.salary), emp.hiringStatus});
+            if (!values.emplace(key, value).second)
+                throw invalid_argument("duplicate argument: " + key);
         }
-        cout << table << endl;
+
+        bool has(const string &key) const { return values.count(key) > 0; }
+
+        string text(const string &key)
+        {
+            auto it = values.find(key);
+            if (it == values.end())
+                throw invalid_argument("missing argument: " + key);
+            used.insert(key);
+            return it->second;
+        }
+
+        int integer(const string &key)
+        {
+            string value = text(key);
+            size_t end = 0;
+            int result = 0;
+            try
+            {
+                result = stoi(value, &end);
+            }
+            catch (const std::exception &)
+            {
+                end = 0;
+            }
+            if (end == 0 || end != value.size())
+                throw invalid_argument(key + " is not a whole number: " + value);
+            return result;
+        }
+
+        double number(const string &key)
+        {
+            string value = text(key);
+            size_t end = 0;
+            double result = 0;
+            try
+            {
+                result = stod(value, &end);
+            }
+            catch (const std::exception &)
+            {
+                end = 0;
+            }
+            if (end == 0 || end != value.size())
+                throw invalid_argument(key + " is not a number: " + value);
+            return result;
+        }
+
+        Money money(const string &key)
+        {
+            string value = text(key);
+            try
+            {
+                return Money::parse(value);
+            }
+            catch (const std::exception &)
+            {
+                throw invalid_argument(key + " is not an amount: " + value);
+            }
+        }
+
+        // YYYY-MM-DD
+        Date date(const string &key)
+        {
+            string value = text(key);
+            Date result{0, 0, 0};
+            char dash1 = 0, dash2 = 0;
+            istringstream in(value);
+            if (!(in >> result.year >> dash1 >> result.month >> dash2 >> result.day) || dash1 != '-' || dash2 != '-' ||
+                !in.eof() || !result.isValid())
+                throw invalid_argument(key + " is not a valid YYYY-MM-DD date: " + value);
+            return result;
+        }
+
+        bool flag(const string &key)
+        {
+            string value = text(key);
+            if (value == "y" || value == "yes" || value == "true" || value == "1")
+                return true;
+            if (value == "n" || value == "no" || value == "false" || value == "0")
+                return false;
+            throw invalid_argument(key + " must be yes or no: " + value);
+        }
+
+        void checkAllUsed() const
+        {
+            for (const auto &entry : values)
+            {
+                if (!used.count(entry.first))
+                    throw invalid_argument("unknown argument: " + entry.first);
+            }
+        }
+    };
+
+    static void parseLine(const string &line, string &command, Arguments &args)
+    {
+        size_t i = 0;
+        auto skipSpaces = [&]
+        {
+            while (i < line.size() && isspace(static_cast<unsigned char>(line[i])))
+                i++;
+        };
+        skipSpaces();
+        while (i < line.size() && !isspace(static_cast<unsigned char>(line[i])))
+            command += line[i++];
+        while (skipSpaces(), i < line.size())
+        {
+            size_t equals = line.find('=', i);
+            size_t space = line.find_first_of(" \t", i);
+            if (equals == string::npos || (space != string::npos && space < equals) || equals == i)
+                throw invalid_argument("expected key=value at: " + line.substr(i));
+            string key = line.substr(i, equals - i);
+            i = equals + 1;
+            string value;
+            if (i < line.size() && line[i] == '"')
+            {
+                size_t close = line.find('"', i + 1);
+                if (close == string::npos)
+                    throw invalid_argument("unterminated quote in " + key);
+                value = line.substr(i + 1, close - i - 1);
+                i = close + 1;
+            }
+            else
+            {
+                while (i < line.size() && !isspace(static_cast<unsigned char>(line[i])))
+                    value += line[i++];
+            }
+            args.add(key, value);
+        }
+    }
+
+    Employee &employee(Arguments &args)
+    {
+        int id = args.integer("id");
+        Employee *emp = employeeIndex.find(id);
+        if (!emp)
+            throw invalid_argument("no employee with ID " + to_string(id));
+        return *emp;
+    }
+
+    bool clientExists(int clientId) const
+    {
+        return any_of(clients.begin(), clients.end(), [clientId](const Client &c)
+                      { return c.id == clientId; });
+    }
+
+    void employeeChanged(const Employee &emp)
+    {
+        employeeIndex.changed(emp);
+        journal.employeeUpserted(emp);
+    }
+
+    void execute(const string &command, Arguments &args)
+    {
+        if (command == "add-employee")
+        {
+            string name = args.text("name");
+            string department = args.text("department");
+            string position = args.text("position");
+            Money salary = args.money("salary");
+            args.checkAllUsed();
+            employees.emplace_back(nextEmployeeId++, name, department, position, salary);
+            employeeIndex.added();
+            journal.employeeUpserted(employees.back());
+        }
+        else if (command == "update-employee")
+        {
+            Employee &emp = employee(args);
+            Employee updated = emp;
+            if (args.has("name"))
+                updated.name = args.text("name");
+            if (args.has("department"))
+                updated.department = args.text("department");
+            if (args.has("position"))
+                updated.position = args.text("position");
+            if (args.has("salary"))
+                updated.salary = args.money("salary");
+            if (args.has("status"))
+                updated.hiringStatus = args.text("status");
+            args.checkAllUsed();
+            emp = move(updated);
+            employeeChanged(emp);
+        }
+        else if (command == "set-status")
+        {
+            Employee &emp = employee(args);
+            string status = args.text("status");
+            args.checkAllUsed();
+            emp.hiringStatus = status;
+            employeeChanged(emp);
+        }
+        else if (command == "assign-department")
+        {
+            Employee &emp = employee(args);
+            string department = args.text("department");
+            args.checkAllUsed();
+            emp.department = department;
+            employeeChanged(emp);
+        }
+        else if (command == "delete-employee")
+        {
+            int id = args.integer("id");
+            args.checkAllUsed();
+            if (!employeeIndex.remove(id))
+                throw invalid_argument("no employee with ID " + to_string(id));
+            journal.employeeDeleted(id);
+        }
+        else if (command == "record-attendance")
+        {
+            Employee &emp = employee(args);
+            Date date = args.date("date");
+            bool present = args.flag("present");
+            args.checkAllUsed();
+            emp.attendance.set(date, present);
+            employeeIndex.attendanceRecorded(emp, date, present);
+            journal.attendanceRecorded(emp.id, date, present);
+        }
+        else if (command == "add-hours")
+        {
+            Employee &emp = employee(args);
+            double hours = args.number("hours");
+            args.checkAllUsed();
+            emp.hoursWorked += hours;
+            employeeChanged(emp);
+        }
+        else if (command == "add-leave")
+        {
+            Employee &emp = employee(args);
+            string type = args.text("type");
+            double days = args.number("days");
+            args.checkAllUsed();
+            if (type == "vacation")
+                emp.vacationDays += days;
+            else if (type == "sick")
+                emp.sickDays += days;
+            else if (type == "other")
+                emp.otherLeaveDays += days;
+            else
+                throw invalid_argument("leave type must be vacation, sick or other: " + type);
+            employeeChanged(emp);
+        }
+        else if (command == "add-client")
+        {
+            string name = args.text("name");
+            string contact = args.text("contact");
+            string email = args.text("email");
+            args.checkAllUsed();
+            clients.emplace_back(nextClientId++, name, contact, email);
+            journal.clientUpserted(clients.back());
+        }
+        else if (command == "assign-client")
+        {
+            Employee &emp = employee(args);
+            int clientId = args.integer("client");
+            args.checkAllUsed();
+            if (!clientExists(clientId))
+                throw invalid_argument("no client with ID " + to_string(clientId));
+            emp.assignedClientId = clientId;
+            employeeChanged(emp);
+        }
+        else if (command == "add-project")
+        {
+            string name = args.text("name");
+            string description = args.has("description") ? args.text("description") : "";
+            Date deadline = args.date("deadline");
+            int clientId = args.integer("client");
+            args.checkAllUsed();
+            if (!clientExists(clientId))
+                throw invalid_argument("no client with ID " + to_string(clientId));
+            projects.emplace_back(nextProjectId++, name, description, deadline, clientId);
+            projectIndex.added();
+            journal.projectUpserted(projects.back());
+        }
+        else if (command == "assign-project")
+        {
+            Employee &emp = employee(args);
+            int projectId = args.integer("project");
+            args.checkAllUsed();
+            if (!projectIndex.find(projectId))
+                throw invalid_argument("no project with ID " + to_string(projectId));
+            emp.assignedProjectId = projectId;
+            employeeChanged(emp);
+        }
+        else if (command == "delete-project")
+        {
+            int id = args.integer("id");
+            args.checkAllUsed();
+            if (!projectIndex.remove(id))
+                throw invalid_argument("no project with ID " + to_string(id));
+            journal.projectDeleted(id);
+            employeeIndex.unassignProject(id);
+        }
+        else
+        {
+            throw invalid_argument("unknown command: " + command);
+        }
+    }
+
+public:
+    struct Summary
+    {
+        size_t commands = 0;
+        size_t failed = 0;
+    };
+
+    BatchCommands(vector<Employee> &allEmployees, EmployeeIndex &index, vector<Client> &allClients, vector<Project> &allProjects,
+                  ProjectIndex &projIndex, int &employeeIdCounter, int &clientIdCounter, int &projectIdCounter, ChangeJournal &changeJournal,
+                  mutex &dataLock)
+        : employees(allEmployees), employeeIndex(index), clients(allClients), projects(allProjects), projectIndex(projIndex),
+          nextEmployeeId(employeeIdCounter), nextClientId(clientIdCounter), nextProjectId(projectIdCounter), journal(changeJournal),
+          dataMutex(dataLock) {}
+
+    // Runs every command in `in`. A failing command is reported with its
+    // line number and skipped; the rest still run.
+    Summary run(istream &in)
+    {
+        Summary summary;
+        string line;
+        size_t lineNumber = 0;
+        while (getline(in, line))
+        {
+            lineNumber++;
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            size_t first = line.find_first_not_of(" \t");
+            if (first == string::npos || line[first] == '#')
+                continue;
+
+            summary.commands++;
+            try
+            {
+                string command;
+                Arguments args;
+                parseLine(line, command, args);
+                lock_guard<mutex> lock(dataMutex);
+                execute(command, args);
+            }
+            catch (const std::exception &e)
+            {
+                summary.failed++;
+                cerr << red("Line ") << lineNumber << red(": ") << e.what() << endl;
+            }
+        }
+        return summary;
     }
 };
 
@@ -1526,17 +5410,26 @@ class WorkerManagementSystem
 private:
     // Main data storage vectors
     vector<Employee> employees;
-    vector<User> users;
+    SlotMap<User> users;
     vector<Client> clients;
     vector<Project> projects;
 
-    User *currentUser; // Points to the currently logged-in user
+    // ID -> slot indexes over employees and projects, shared by all feature classes
+    EmployeeIndex employeeIndex;
+    ProjectIndex projectIndex;
+
+    // Stays valid (or safely null) across sign-ups and user deletions
+    SlotMap<User>::Handle currentUserHandle; // Handle of the currently logged-in user
+    User *currentUser() { return users.get(currentUserHandle); }
 
     // ID counters
     int nextEmployeeId;
     int nextClientId;
     int nextProjectId;
 
+    // Mutations are journaled; the workbook is only rewritten at checkpoints
+    ChangeJournal journal;
+
     // Feature class instances
     UserAuthenticationSystem userAuthSystem;
     EmployeeManagement employeeManagement;
@@ -1546,27 +5439,63 @@ private:
     ProjectManagement projectManagement;
     BusinessIntelligence businessIntelligence;
 
-    // The single data file for the system
+    // Native snapshot used for persistence; the workbook is kept in sync on
+    // exit for interop with Excel and is imported when it is the newer file
+    const string snapshotFile = "worker_data.snap";
     const string systemDataFile = "worker_data.xlsx";
+    atomic<bool> excelExportDue{false}; // Snapshot has changes the workbook lacks
+    uint32_t forcedSections = 0;        // Sections to rewrite even if the journal did not touch them
+    bool savingBlocked = false;         // A data file could not be read nor moved aside; changes stay in the journal
+
+    // Held by the UI thread while a menu action mutates the data and by the
+    // saver while it copies the data
+    mutex dataMutex;
+
+    // Copy of the data taken for a checkpoint; only the collections being
+    // rewritten are filled in
+    struct SystemDataCopy
+    {
+        vector<Employee> employees;
+        vector<Client> clients;
+        vector<Project> projects;
+        int nextEmployeeId;
+        int nextClientId;
+        int nextProjectId;
+    };
+
+    // Declared last so the saver thread stops before the data it saves is destroyed
+    PersistenceWorker persistence;
 
 public:
-    WorkerManagementSystem() : currentUser(nullptr),
+    WorkerManagementSystem() : employeeIndex(employees),
+                               projectIndex(projects),
                                nextEmployeeId(1),
                                nextClientId(1),
                                nextProjectId(1),
-                               userAuthSystem(users, currentUser),
-                               employeeManagement(employees, nextEmployeeId),
-                               resourceManagement(employees),
-                               timeManagement(employees),
-                               clientRelationshipManagement(clients, employees, projects, nextClientId),
-                               projectManagement(projects, employees, clients, nextProjectId),
-                               businessIntelligence(employees)
+                               journal("worker_data.journal"),
+                               userAuthSystem(users, currentUserHandle),
+                               employeeManagement(employees, employeeIndex, nextEmployeeId, journal, dataMutex),
+                               resourceManagement(employees, employeeIndex, journal, dataMutex),
+                               timeManagement(employees, employeeIndex, journal, dataMutex),
+                               clientRelationshipManagement(clients, employees, employeeIndex, projects, projectIndex, nextClientId, journal, dataMutex),
+                               projectManagement(projects, employees, employeeIndex, projectIndex, clients, nextProjectId, journal, dataMutex),
+                               businessIntelligence(employees, employeeIndex),
+                               persistence([this]
+                                           { return checkpoint(); })
     {
         // Attempt to load data on startup
         loadSystemDataFromFile();
+        persistence.start();
+    }
+
+    void saveSystemDataToFile(const SystemDataCopy &data, uint32_t sections, bool workbookInSync = false)
+    {
+        BinarySnapshot::save(snapshotFile, data.employees, data.clients, data.projects,
+                             data.nextEmployeeId, data.nextClientId, data.nextProjectId, workbookInSync, sections);
+        excelExportDue = !workbookInSync;
     }
 
-    void saveSystemDataToFile()
+    void exportSystemDataToExcel()
     {
         xlnt::workbook wb;
 
@@ -1600,10 +5529,10 @@ public:
         {
             emp_ws.cell(1, row).value(emp.id);
             emp_ws.cell(2, row).value(emp.name);
-            emp_ws.cell(3, row).value(emp.department);
-            emp_ws.cell(4, row).value(emp.position);
-            emp_ws.cell(5, row).value(emp.salary);
-            emp_ws.cell(6, row).value(emp.hiringStatus);
+            emp_ws.cell(3, row).value(emp.department.str());
+            emp_ws.cell(4, row).value(emp.position.str());
+            emp_ws.cell(5, row).value(emp.salary.toDouble());
+            emp_ws.cell(6, row).value(emp.hiringStatus.str());
             emp_ws.cell(7, row).value(emp.hoursWorked);
             emp_ws.cell(8, row).value(emp.vacationDays);
             emp_ws.cell(9, row).value(emp.sickDays);
@@ -1624,15 +5553,14 @@ public:
         row = 2;
         for (const auto &emp : employees)
         {
-            for (const auto &record : emp.attendance)
-            {
+            emp.attendance.forEach([&](const Date &date, bool present)
+                                   {
                 att_ws.cell(1, row).value(emp.id);
-                att_ws.cell(2, row).value(record.first.year);
-                att_ws.cell(3, row).value(record.first.month);
-                att_ws.cell(4, row).value(record.first.day);
-                att_ws.cell(5, row).value(record.second);
-                row++;
-            }
+                att_ws.cell(2, row).value(date.year);
+                att_ws.cell(3, row).value(date.month);
+                att_ws.cell(4, row).value(date.day);
+                att_ws.cell(5, row).value(present);
+                row++; });
         }
 
 
@@ -1676,103 +5604,192 @@ public:
             row++;
         }
 
-        wb.save(systemDataFile);
-        // Silently save in the background, or uncomment below for a message.
-        // cout << green("System data auto-saved to ") << systemDataFile << endl;
+        // Write to a temporary file first so a crash mid-save never leaves
+        // a half-written checkpoint behind
+        const string tempFile = systemDataFile + ".tmp";
+        wb.save(tempFile);
+        filesystem::rename(tempFile, systemDataFile);
     }
 
-    void loadSystemDataFromFile()
+    // Writes a new snapshot and drops the journal records it contains.
+    // Only copying the data happens under the data lock, so the UI never
+    // waits for the disk. Runs on the saver thread during a session.
+    bool checkpoint(bool workbookInSync = false)
     {
+        if (savingBlocked)
+            return true; // Nothing to retry; the journal keeps the changes
         try
         {
-            xlnt::workbook wb;
-            wb.load(systemDataFile);
-
-            employees.clear();
-            clients.clear();
-            projects.clear();
-
-            // Metadata
-            auto meta_ws = wb.sheet_by_title("Metadata");
-            nextEmployeeId = meta_ws.cell("B1").value<int>();
-            nextClientId = meta_ws.cell("B2").value<int>();
-            nextProjectId = meta_ws.cell("B3").value<int>();
-
-            // Employees
-            auto emp_ws = wb.sheet_by_title("Employees");
-            for (auto row : emp_ws.rows(false))
-            {
-                if (row[0].to_string() == "ID")
-                    continue; // Skip header
-                Employee emp(row[0].value<int>(), row[1].to_string(), row[2].to_string(), row[3].to_string(), row[4].value<double>());
-                emp.hiringStatus = row[5].to_string();
-                emp.hoursWorked = row[6].value<double>();
-                emp.vacationDays = row[7].value<double>();
-                emp.sickDays = row[8].value<double>();
-                emp.otherLeaveDays = row[9].value<double>();
-                emp.assignedClientId = row[10].value<int>();
-                emp.assignedProjectId = row[11].value<int>();
-                employees.push_back(emp);
-            }
-
-            // --- NEW: Load Attendance ---
-            if(wb.contains("Attendance")){
-                auto att_ws = wb.sheet_by_title("Attendance");
-                for (auto row : att_ws.rows(false)) {
-                    if (row[0].to_string() == "EmployeeID") continue; // Skip header
-
-                    int empId = row[0].value<int>();
-                    Date date = {row[1].value<int>(), row[2].value<int>(), row[3].value<int>()};
-                    bool present = row[4].value<bool>();
-                    
-                    // Find employee and add attendance
-                    for(auto& emp : employees) {
-                        if (emp.id == empId) {
-                            emp.attendance[date] = present;
-                            break;
-                        }
-                    }
-                }
+            SystemDataCopy data;
+            uint32_t sections;
+            {
+                lock_guard<mutex> lock(dataMutex);
+                // save() also writes missing segments, so they need their data copied
+                sections = journal.rotate() | forcedSections | BinarySnapshot::missingSections(snapshotFile);
+                if (sections & (SECTION_EMPLOYEES | SECTION_ATTENDANCE))
+                    data.employees = liveRecords(employees, employeeIndex);
+                if (sections & SECTION_CLIENTS)
+                    data.clients = clients;
+                if (sections & SECTION_PROJECTS)
+                    data.projects = liveRecords(projects, projectIndex);
+                data.nextEmployeeId = nextEmployeeId;
+                data.nextClientId = nextClientId;
+                data.nextProjectId = nextProjectId;
             }
+            saveSystemDataToFile(data, sections, workbookInSync);
+            journal.dropRotated();
+            forcedSections = 0;
+            return true;
+        }
+        catch (const std::exception &e)
+        {
+            // The rotated journal is kept, so nothing is lost
+            cerr << red("Error writing checkpoint: ") << e.what() << endl;
+            return false;
+        }
+    }
+
+    // Copy of the records whose slots are not tombstoned
+    template <typename Record, typename Index>
+    static vector<Record> liveRecords(const vector<Record> &records, const Index &index)
+    {
+        vector<Record> live;
+        live.reserve(index.liveCount());
+        for (size_t slot = 0; slot < records.size(); slot++)
+        {
+            if (index.isLive(slot))
+                live.push_back(records[slot]);
+        }
+        return live;
+    }
+
+    // Runs a mutating menu action, then wakes the saver thread. The action
+    // prompts without the data lock and takes it only around its change and
+    // journal record, so the saver never waits on the user. Only this thread
+    // changes the data, so reading it without the lock is safe here.
+    // Deletes leave tombstones, which are compacted here once they pile up;
+    // readers run on this thread, so they never see slots move under them.
+    template <typename Action>
+    void mutate(Action action)
+    {
+        action();
+        {
+            lock_guard<mutex> lock(dataMutex);
+            employeeIndex.compactIfSparse();
+            projectIndex.compactIfSparse();
+        }
+        persistence.markDirty();
+    }
+
+    void loadSystemDataFromFile()
+    {
+        error_code ec;
+        bool haveSnapshot = filesystem::exists(snapshotFile, ec);
+        bool haveWorkbook = filesystem::exists(systemDataFile, ec);
+        bool workbookIsNewer = haveSnapshot && haveWorkbook &&
+                               filesystem::last_write_time(systemDataFile, ec) > filesystem::last_write_time(snapshotFile, ec);
+
+        // The newer file is tried first and the other one if that fails
+        bool loaded = false, imported = false;
+        if (haveSnapshot && !workbookIsNewer)
+            loaded = loadSnapshot();
+        if (!loaded && haveWorkbook)
+            imported = importSystemDataFromExcel();
+        if (!loaded && !imported && haveSnapshot && workbookIsNewer)
+            loaded = loadSnapshot();
+        if (!loaded)
+        {
+            // None of the snapshot segments on disk can be trusted now
+            forcedSections = ALL_SECTIONS;
+        }
 
+        // Bring the checkpoint up to date with changes made after it was written
+        employeeIndex.rebuild();
+        projectIndex.rebuild();
+        size_t replayed = journal.replay(employees, employeeIndex, clients, projects, projectIndex, nextEmployeeId, nextClientId, nextProjectId);
+        employeeIndex.compact();
+        projectIndex.compact();
+        if (replayed > 0)
+            cout << green("Replayed ") << replayed << green(" journaled change(s).") << endl;
+
+        // Migrate an imported workbook to the snapshot straight away. A first
+        // run has only the journal to save; when a data file exists but
+        // could not be read, nothing is written until the next session.
+        if (!loaded && (imported || (!haveSnapshot && !haveWorkbook && replayed > 0)))
+            checkpoint(imported && replayed == 0);
+    }
 
-            // Clients
-            auto client_ws = wb.sheet_by_title("Clients");
-            for (auto row : client_ws.rows(false))
+    // An unreadable snapshot is moved aside rather than overwritten
+    bool loadSnapshot()
+    {
+        try
+        {
+            bool workbookInSync = false, segmented = true;
+            if (!BinarySnapshot::load(snapshotFile, employees, clients, projects, nextEmployeeId, nextClientId, nextProjectId,
+                                      workbookInSync, segmented))
+                return false;
+            excelExportDue = !workbookInSync;
+            // A partial checkpoint copies only the dirty sections, so a
+            // version 1 snapshot has to be split into segments in full
+            if (!segmented)
+                forcedSections = ALL_SECTIONS;
+            cout << green("System data loaded from ") << snapshotFile << green(" successfully.") << endl;
+            return true;
+        }
+        catch (const std::exception &e)
+        {
+            cout << yellow("Warning: Could not read ") << snapshotFile << yellow(": ") << e.what() << endl;
+            if (BinarySnapshot::setAside(snapshotFile))
             {
-                if (row[0].to_string() == "ID")
-                    continue; // Skip header
-                clients.emplace_back(row[0].value<int>(), row[1].to_string(), row[2].to_string(), row[3].to_string());
+                cout << yellow("It was kept as ") << snapshotFile << ".corrupt" << endl;
             }
-
-            // Projects
-            auto project_ws = wb.sheet_by_title("Projects");
-            for (auto row : project_ws.rows(false))
+            else
             {
-                if (row[0].to_string() == "ID")
-                    continue; // Skip header
-                projects.emplace_back(row[0].value<int>(), row[1].to_string(), row[2].to_string(), Date{row[3].value<int>(), row[4].value<int>(), row[5].value<int>()}, row[6].value<int>());
+                cout << red("It could not be moved aside, so changes will only be journaled.") << endl;
+                savingBlocked = true;
             }
+            return false;
+        }
+    }
+
+    // An unreadable workbook is moved aside rather than overwritten
+    bool importSystemDataFromExcel()
+    {
+        try
+        {
+            WorkbookImporter::load(systemDataFile, employees, clients, projects, nextEmployeeId, nextClientId, nextProjectId);
             cout << green("System data loaded from ") << systemDataFile << green(" successfully.") << endl;
+            return true;
         }
-        catch (const xlnt::exception &e)
+        catch (const std::exception &e)
         {
-            cout << red("Note: Could not load ") << systemDataFile << red(". A new file will be created upon saving.") << endl;
+            cout << yellow("Warning: Could not load ") << systemDataFile << yellow(": ") << e.what() << endl;
+            error_code ec;
+            filesystem::rename(systemDataFile, systemDataFile + ".corrupt", ec);
+            if (!ec)
+            {
+                cout << yellow("It was kept as ") << systemDataFile << ".corrupt" << endl;
+            }
+            else
+            {
+                cout << red("It could not be moved aside, so changes will only be journaled.") << endl;
+                savingBlocked = true;
+            }
+            return false;
         }
     }
 
     void showMainMenu()
     {
-        system("cls");
-        if (!currentUser)
+        if (!currentUser())
         {
-            printHeaderStyle3("Welcome to Worker Management System");
-            menuLogin();
+            Screen::get().frame([]
+                                { printHeaderStyle3("Welcome to Worker Management System"); menuLogin(); });
         }
         else
         {
-            printAppLogo();
-            menuMain();
+            Screen::get().frame([]
+                                { printAppLogo(); menuMain(); });
         }
     }
 
@@ -1782,38 +5799,37 @@ public:
         int choice;
         do
         {
-            system("cls");
-            Process_Management();
-            menuPM();
+            Screen::get().frame([]
+                                { Process_Management(); menuPM(); });
             cin >> choice;
             switch (choice)
             {
             case 1:
-                system("cls");
+                Screen::get().clear();
                 printtHeader("Add New Employee");
-                employeeManagement.addEmployee(currentUser);
-                saveSystemDataToFile(); // AUTO-SAVE
+                mutate([&]
+                       { employeeManagement.addEmployee(currentUser()); }); // AUTO-SAVE
                 pressEnter();
                 break;
             case 2:
-                system("cls");
+                Screen::get().clear();
                 printtHeader("Update Employee Details");
-                employeeManagement.updateEmployeeDetails(currentUser);
-                saveSystemDataToFile(); // AUTO-SAVE
+                mutate([&]
+                       { employeeManagement.updateEmployeeDetails(currentUser()); }); // AUTO-SAVE
                 pressEnter();
                 break;
             case 3:
-                system("cls");
+                Screen::get().clear();
                 printtHeader("Delete Employee Record");
-                employeeManagement.deleteEmployeeRecord(currentUser);
-                saveSystemDataToFile(); // AUTO-SAVE
+                mutate([&]
+                       { employeeManagement.deleteEmployeeRecord(currentUser()); }); // AUTO-SAVE
                 pressEnter();
                 break;
             case 4:
-                system("cls");
+                Screen::get().clear();
                 printtHeader("Set Hiring Status");
-                employeeManagement.setHiringStatus(currentUser);
-                saveSystemDataToFile(); // AUTO-SAVE
+                mutate([&]
+                       { employeeManagement.setHiringStatus(currentUser()); }); // AUTO-SAVE
                 pressEnter();
                 break;
             case 5:
@@ -1828,36 +5844,35 @@ public:
         int choice;
         do
         {
-            system("cls");
-            Resource_Management();
-            menuRM();
+            Screen::get().frame([]
+                                { Resource_Management(); menuRM(); });
             cin >> choice;
             switch (choice)
             {
             case 1:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Assign Employee to Department");
-                resourceManagement.assignEmployeeToDepartment(currentUser);
-                saveSystemDataToFile(); // AUTO-SAVE
+                mutate([&]
+                       { resourceManagement.assignEmployeeToDepartment(currentUser()); }); // AUTO-SAVE
                 pressEnter();
                 break;
             case 2:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("View Resource Allocation per Department");
-                resourceManagement.viewResourceAllocationPerDepartment(currentUser);
+                resourceManagement.viewResourceAllocationPerDepartment(currentUser());
                 pressEnter();
                 break;
             case 3:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Reassign Employees between Departments");
-                resourceManagement.reassignEmployeesBetweenDepartments(currentUser);
-                saveSystemDataToFile(); // AUTO-SAVE
+                mutate([&]
+                       { resourceManagement.reassignEmployeesBetweenDepartments(currentUser()); }); // AUTO-SAVE
                 pressEnter();
                 break;
             case 4:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("View Position/Role Distribution");
-                resourceManagement.viewPositionRoleDistribution(currentUser);
+                resourceManagement.viewPositionRoleDistribution(currentUser());
                 pressEnter();
                 break;
             case 5:
@@ -1872,70 +5887,80 @@ public:
         int choice;
         do
         {
-            system("cls");
-            Time_Management();
-            menuTM();
+            Screen::get().frame([]
+                                { Time_Management(); menuTM(); });
             cin >> choice;
             switch (choice)
             {
             case 1:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Record Employee Attendance");
-                timeManagement.recordEmployeeAttendance(currentUser);
-                saveSystemDataToFile(); // AUTO-SAVE
+                mutate([&]
+                       { timeManagement.recordEmployeeAttendance(currentUser()); }); // AUTO-SAVE
                 pressEnter();
                 break;
             case 2:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Track Work Hours or Shifts");
-                timeManagement.trackWorkHoursOrShifts(currentUser);
-                saveSystemDataToFile(); // AUTO-SAVE
+                mutate([&]
+                       { timeManagement.trackWorkHoursOrShifts(currentUser()); }); // AUTO-SAVE
                 pressEnter();
                 break;
             case 3:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Manage Leave Balances");
-                timeManagement.manageLeaveBalances(currentUser);
-                saveSystemDataToFile(); // AUTO-SAVE
+                mutate([&]
+                       { timeManagement.manageLeaveBalances(currentUser()); }); // AUTO-SAVE
                 pressEnter();
                 break;
             case 4:
+                Screen::get().clear();
+                printHeaderStyle1("Attendance Report by Date");
+                timeManagement.attendanceReportByDate(currentUser());
+                pressEnter();
+                break;
+            case 5:
+                Screen::get().clear();
+                printHeaderStyle1("Attendance Rates and Absence Streaks");
+                timeManagement.attendanceRatesReport(currentUser());
+                pressEnter();
+                break;
+            case 6:
                 break;
             default:
                 cout << "Invalid choice. Please try again." << endl;
             }
-        } while (choice != 4);
+        } while (choice != 6);
     }
     void clientRelationshipManagementMenu()
     {
         int choice;
         do
         {
-            system("cls");
-            Client_Relationship_Management();
-            menuCRM();
+            Screen::get().frame([]
+                                { Client_Relationship_Management(); menuCRM(); });
             cin >> choice;
             switch (choice)
             {
             case 1:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Add Client Record");
-                clientRelationshipManagement.addClientRecord(currentUser);
-                saveSystemDataToFile(); // AUTO-SAVE
+                mutate([&]
+                       { clientRelationshipManagement.addClientRecord(currentUser()); }); // AUTO-SAVE
                 pressEnter();
                 break;
             case 2:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Assign Employees to Clients/Accounts");
-                clientRelationshipManagement.assignEmployeesToClientsAccounts(currentUser);
-                saveSystemDataToFile(); // AUTO-SAVE
+                mutate([&]
+                       { clientRelationshipManagement.assignEmployeesToClientsAccounts(currentUser()); }); // AUTO-SAVE
                 pressEnter();
                 break;
 
             case 3:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("View All Clients");
-                clientRelationshipManagement.displayAllClients(currentUser);
+                clientRelationshipManagement.displayAllClients(currentUser());
                 pressEnter();
                 break;
             case 4:
@@ -1953,49 +5978,48 @@ public:
         int choice;
         do
         {
-            system("cls");
-            printtHeader("Project Management");
-            menuPMM();
+            Screen::get().frame([]
+                                { printtHeader("Project Management"); menuPMM(); });
             cin >> choice;
             switch (choice)
             {
             case 1:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Create Project");
-                projectManagement.createProject(currentUser);
-                saveSystemDataToFile(); // AUTO-SAVE
+                mutate([&]
+                       { projectManagement.createProject(currentUser()); }); // AUTO-SAVE
                 pressEnter();
                 break;
             case 2:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Assign Employees to Projects");
-                projectManagement.assignEmployeesToProjects(currentUser);
-                saveSystemDataToFile(); // AUTO-SAVE
+                mutate([&]
+                       { projectManagement.assignEmployeesToProjects(currentUser()); }); // AUTO-SAVE
                 pressEnter();
                 break;
             case 3:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Track Project Deadlines");
-                projectManagement.trackProjectDeadlines(currentUser);
+                projectManagement.trackProjectDeadlines(currentUser());
                 pressEnter();
                 break;
             case 4:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("View Employees Assigned to Projects");
-                projectManagement.viewEmployeesAssignedToProjects(currentUser);
+                projectManagement.viewEmployeesAssignedToProjects(currentUser());
                 pressEnter();
                 break;
             case 5:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Delete Project");
-                projectManagement.deleteProject(currentUser);
-                saveSystemDataToFile(); // AUTO-SAVE
+                mutate([&]
+                       { projectManagement.deleteProject(currentUser()); }); // AUTO-SAVE
                 pressEnter();
                 break;
             case 6:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Track Client-Specific Projects or Contacts");
-                clientRelationshipManagement.trackClientSpecificProjectsOrContacts(currentUser);
+                clientRelationshipManagement.trackClientSpecificProjectsOrContacts(currentUser());
                 pressEnter();
                 break;
             case 7:
@@ -2010,35 +6034,33 @@ public:
         int choice;
         do
         {
-            system("cls");
-            Business_Intelligence();
-            menuBI();
+            Screen::get().frame([]
+                                { Business_Intelligence(); menuBI(); });
             cin >> choice;
             switch (choice)
             {
             case 1:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Count Total Employees");
-                businessIntelligence.countTotalEmployees(currentUser);
+                businessIntelligence.countTotalEmployees(currentUser());
                 pressEnter();
                 break;
             case 2:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Department-wise Employee Statistics");
-                businessIntelligence.departmentWiseEmployeeStatistics(currentUser);
+                businessIntelligence.departmentWiseEmployeeStatistics(currentUser());
                 pressEnter();
                 break;
             case 3:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Average, Max, and Min Salaries");
-                businessIntelligence.calculateSalaryMetrics(currentUser);
+                businessIntelligence.calculateSalaryMetrics(currentUser());
                 pressEnter();
                 break;
             case 4:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Sort Employees");
-                businessIntelligence.sortEmployees(currentUser);
-                saveSystemDataToFile(); // AUTO-SAVE
+                businessIntelligence.sortEmployees(currentUser());
                 pressEnter();
                 break;
             case 5:
@@ -2053,41 +6075,46 @@ public:
         int choice;
         do
         {
-            system("cls");
-            Base_System_Features();
-            menuBF();
+            Screen::get().frame([]
+                                { Base_System_Features(); menuBF(); });
             cin >> choice;
             switch (choice)
             {
             case 1:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Display All Employees");
-                employeeManagement.displayAllEmployees(currentUser);
+                employeeManagement.displayAllEmployees(currentUser());
                 pressEnter();
                 break;
             case 2:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Display One Employee by ID");
-                employeeManagement.displayOneEmployeeByID(currentUser);
+                employeeManagement.displayOneEmployeeByID(currentUser());
                 pressEnter();
                 break;
             case 3:
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Search Employees");
-                employeeManagement.searchEmployees(currentUser);
+                employeeManagement.searchEmployees(currentUser());
                 pressEnter();
                 break;
             case 4:
+                Screen::get().clear();
+                printHeaderStyle1("Filter Employees");
+                employeeManagement.filterEmployees(currentUser());
+                pressEnter();
+                break;
+            case 5:
                 break;
             default:
                 cout << red("Invalid choice. Please try again.") << endl;
             }
-        } while (choice != );
+        } while (choice != 5);
     }
 
     void userManagementMenu()
     {
-        if (!currentUser || currentUser->role != ADMIN)
+        if (!currentUser() || currentUser()->role != ADMIN)
         {
             cout << red("Permission Denied. This feature is for Admins only.") << endl;
             pressEnter();
@@ -2097,16 +6124,15 @@ public:
         int choice;
         do
         {
-            system("cls");
-            User_Management();
-            menuUM(); // Assumed to exist in header.h to show options
+            Screen::get().frame([]
+                                { User_Management(); menuUM(); }); // Assumed to exist in header.h to show options
             cin >> choice;
 
             switch (choice)
             {
             case 1: // Add User
             {
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Add New User");
                 string newUsername, newPassword;
                 cout << "Enter new username: ";
@@ -2121,7 +6147,7 @@ public:
             }
             case 2: // Delete User
             {
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Delete User");
                 string usernameToDelete;
                 cout << "Enter username to delete: ";
@@ -2132,7 +6158,7 @@ public:
             }
             case 3: // Manage User Role
             {
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("Manage User Role");
                 string usernameToManage;
                 cout << "Enter username to manage: ";
@@ -2143,7 +6169,7 @@ public:
             }
             case 4: // View All Users
             {
-                system("cls");
+                Screen::get().clear();
                 printHeaderStyle1("View All Users");
                 userAuthSystem.displayAllUsers();
                 pressEnter();
@@ -2174,7 +6200,7 @@ public:
                 choice = 0; // reset choice
             }
 
-            if (currentUser) // User is logged in
+            if (currentUser()) // User is logged in
             {
                 switch (choice)
                 {
@@ -2228,7 +6254,81 @@ public:
                     pressEnter();
                 }
             }
-        } while ((currentUser && choice != 9) || (!currentUser && choice != 3));
+        } while ((currentUser() && choice != 9) || (!currentUser() && choice != 3));
+
+        flushOnExit();
+    }
+
+    // Runs the batch commands in `path` ("-" for stdin) without the menus or
+    // a login, then saves once. Returns the process exit code: 0 if every
+    // command succeeded, 1 if any failed, 2 if the file cannot be read.
+    int runBatch(const string &path)
+    {
+        ifstream file;
+        if (path != "-")
+        {
+            file.open(path);
+            if (!file)
+            {
+                cerr << red("Cannot open batch file ") << path << endl;
+                return 2;
+            }
+        }
+        istream &in = path == "-" ? cin : file;
+
+        BatchCommands batch(employees, employeeIndex, clients, projects, projectIndex,
+                            nextEmployeeId, nextClientId, nextProjectId, journal, dataMutex);
+        BatchCommands::Summary summary;
+        auto started = chrono::steady_clock::now();
+        // No flush per journal record; the journal is flushed and the data
+        // saved once the batch is done
+        auto setJournalFlushing = [&](bool enabled)
+        {
+            lock_guard<mutex> lock(dataMutex);
+            journal.setFlushEachRecord(enabled);
+        };
+        setJournalFlushing(false);
+        mutate([&]
+               { summary = batch.run(in); });
+        setJournalFlushing(true);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+
+        cout << green("Batch finished: ") << summary.commands << " commands, " << summary.failed << " failed, "
+             << to_string_with_precision(seconds, 3) << " s";
+        if (seconds > 0)
+            cout << " (" << to_string_with_precision(summary.commands / seconds, 0) << " commands/s)";
+        cout << endl;
+
+        flushOnExit();
+        return summary.failed == 0 ? 0 : 1;
+    }
+
+    // Flush on a clean exit: refresh the workbook first, so the snapshot
+    // stays the newer of the two files, then fold in the journal
+    void flushOnExit()
+    {
+        persistence.stop();
+        employeeIndex.compact();
+        projectIndex.compact();
+        if (savingBlocked)
+        {
+            cout << yellow("Changes were kept in the journal only; the data files were not rewritten.") << endl;
+            return;
+        }
+        if (journal.pending() > 0 || journal.hasRotated() || excelExportDue)
+        {
+            bool exported = false;
+            try
+            {
+                exportSystemDataToExcel();
+                exported = true;
+            }
+            catch (const std::exception &e)
+            {
+                cerr << red("Error exporting ") << systemDataFile << red(": ") << e.what() << endl;
+            }
+            checkpoint(exported);
+        }
     }
 };
 #endif
\ No newline at end of file
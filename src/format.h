@@ -0,0 +1,85 @@
+#ifndef FORMAT_H
+#define FORMAT_H
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Number and date formatting into caller-provided buffers, built on
+// std::to_chars: no streams, no locale, no heap. Each function writes at
+// `first`, never past `last`, and returns the end of what it wrote, so
+// results can be appended to a larger buffer or wrapped in a string_view.
+// Buffers of formatBufferSize chars are always large enough.
+
+constexpr size_t formatBufferSize = 64;
+
+inline char *formatInteger(char *first, char *last, int64_t value)
+{
+    return std::to_chars(first, last, value).ptr;
+}
+
+// Fixed notation with `precision` decimals, like std::fixed; values too
+// large for the buffer fall back to the shortest round-trip form
+inline char *formatFixed(char *first, char *last, double value, int precision)
+{
+#if defined(__cpp_lib_to_chars)
+    std::to_chars_result result = std::to_chars(first, last, value, std::chars_format::fixed, precision);
+    if (result.ec == std::errc())
+        return result.ptr;
+    return std::to_chars(first, last, value).ptr;
+#else
+    int written = std::snprintf(first, static_cast<size_t>(last - first), "%.*f", precision, value);
+    if (written < 0 || written >= last - first)
+        written = std::snprintf(first, static_cast<size_t>(last - first), "%.17g", value);
+    return first + (written < 0 ? 0 : written);
+#endif
+}
+
+// Shortest text that reads back as exactly `value`
+inline char *formatShortest(char *first, char *last, double value)
+{
+#if defined(__cpp_lib_to_chars)
+    return std::to_chars(first, last, value).ptr;
+#else
+    int written = std::snprintf(first, static_cast<size_t>(last - first), "%.17g", value);
+    return first + (written < 0 ? 0 : written);
+#endif
+}
+
+// Whole number of cents as a plain decimal with two places, e.g. "-12.05"
+inline char *formatCents(char *first, char *last, int64_t cents)
+{
+    uint64_t magnitude = cents < 0 ? uint64_t(0) - uint64_t(cents) : uint64_t(cents);
+    if (cents < 0 && first != last)
+        *first++ = '-';
+    first = std::to_chars(first, last, magnitude / 100).ptr;
+    if (last - first < 3)
+        return first;
+    unsigned fraction = static_cast<unsigned>(magnitude % 100);
+    first[0] = '.';
+    first[1] = static_cast<char>('0' + fraction / 10);
+    first[2] = static_cast<char>('0' + fraction % 10);
+    return first + 3;
+}
+
+// ISO 8601 date, YYYY-MM-DD
+inline char *formatIsoDate(char *first, char *last, int year, int month, int day)
+{
+    auto twoDigits = [&](int value)
+    {
+        if (last - first < 2)
+            return;
+        *first++ = static_cast<char>('0' + value / 10 % 10);
+        *first++ = static_cast<char>('0' + value % 10);
+    };
+    first = std::to_chars(first, last, year).ptr;
+    if (first != last)
+        *first++ = '-';
+    twoDigits(month);
+    if (first != last)
+        *first++ = '-';
+    twoDigits(day);
+    return first;
+}
+
+#endif
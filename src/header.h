@@ -7,13 +7,33 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <set>
+#include <deque>
+#include <array>
+#include <bitset>
+#include <unordered_map>
+#include <unordered_set>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <cmath>
 #include <algorithm> 
 #include <numeric>   
 #include <iomanip>   
 #include <fstream>   
+#include <filesystem>
 #include <sstream>
 #include <tabulate/table.hpp>
 #include <xlnt/xlnt.hpp> 
+#include <xlnt/workbook/streaming_workbook_reader.hpp>
 using namespace std;
 using namespace tabulate;
 #endif
\ No newline at end of file
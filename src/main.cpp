@@ -3,9 +3,12 @@
 #include "textcolor.h"
 #include "menustyle.h"
 #include "classmain.h"
-int main()
+int main(int argc, char *argv[])
 {
     WorkerManagementSystem wms;
+    // --batch FILE runs commands headless; without FILE, or with -, they are read from stdin
+    if (argc > 1 && string(argv[1]) == "--batch")
+        return wms.runBatch(argc > 2 ? argv[2] : "-");
     wms.run();
     return 0;
 }
@@ -1,6 +1,7 @@
 #ifndef MENUSTYLE_H
 #define MENUSTYLE_H
 #include "header.h"
+#include "screen.h"
 
 using namespace std;
 
@@ -150,6 +151,8 @@ void menuTM()
         "Record Employee Attendance",
         "Track Work Hours or Shifts",
         "Manage Leave Balances",
+        "Attendance Report by Date",
+        "Attendance Rates and Absence Streaks",
         "Back to Main Menu"};
     Table t;
     t.add_row({"No", "Menu"});
@@ -161,7 +164,7 @@ void menuTM()
     t[0].format().font_color(Color::yellow);
     for (int i = 1; i <= menuMain.size(); i++)
     {
-        if (i == 4) // Exit option
+        if (i == 6) // Exit option
             t[i][1].format().font_color(Color::red);
         else
             t[i][1].format().font_color(Color::cyan);
@@ -270,6 +273,7 @@ void menuBF()
         "Display All Employees",
         "Display One Employee by ID",
         "Search Employees",
+        "Filter Employees",
         "Back to Main Menu"};
     Table t;
     t.add_row({"No", "Menu"});
@@ -281,7 +285,7 @@ void menuBF()
     t[0].format().font_color(Color::yellow);
     for (int i = 1; i <= menuMain.size(); i++)
     {
-        if (i == 4) // Exit option
+        if (i == 5) // Exit option
             t[i][1].format().font_color(Color::red);
         else
             t[i][1].format().font_color(Color::cyan);
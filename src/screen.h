@@ -0,0 +1,176 @@
+#ifndef SCREEN_H
+#define SCREEN_H
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+#endif
+
+// Terminal screen driven by ANSI escape sequences instead of system("cls").
+//
+// Menu screens are drawn as frames: the output of the draw function is
+// captured and compared with the previous frame line by line, and only
+// the lines that differ are repainted. That is only safe while the
+// terminal still shows the previous frame, so cout and cerr are routed
+// through counting buffers and any output between two frames forces a full
+// redraw. The saver thread reports errors on cerr, so the count is guarded
+// by a lock that a frame holds while it draws. Typed input is echoed by the
+// terminal on the frame's last line (the prompt) and below it, so those
+// are always repainted.
+class Screen
+{
+private:
+    // Forwards to a real output buffer and counts what passes through
+    class CountingBuffer : public std::streambuf
+    {
+    private:
+        std::streambuf *target;
+        size_t &written;
+        std::recursive_mutex &guard;
+
+    protected:
+        int overflow(int ch) override
+        {
+            if (ch == traits_type::eof())
+                return traits_type::not_eof(ch);
+            std::lock_guard<std::recursive_mutex> lock(guard);
+            written++;
+            return target->sputc(static_cast<char>(ch));
+        }
+
+        std::streamsize xsputn(const char *text, std::streamsize count) override
+        {
+            std::lock_guard<std::recursive_mutex> lock(guard);
+            written += static_cast<size_t>(count);
+            return target->sputn(text, count);
+        }
+
+        int sync() override { return target->pubsync(); }
+
+    public:
+        CountingBuffer(std::streambuf *out, size_t &counter, std::recursive_mutex &lock)
+            : target(out), written(counter), guard(lock) {}
+        std::streambuf *underlying() const { return target; }
+    };
+
+    std::recursive_mutex guard;
+    size_t written = 0; // Characters sent to the terminal since the last frame
+    CountingBuffer output;
+    CountingBuffer errors;
+    std::vector<std::string> shown; // Lines of the frame on screen; empty if unknown
+
+    Screen() : output(std::cout.rdbuf(), written, guard), errors(std::cerr.rdbuf(), written, guard)
+    {
+#ifdef _WIN32
+        // Older consoles only interpret escape sequences when asked to
+        HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+        DWORD mode = 0;
+        if (console != INVALID_HANDLE_VALUE && GetConsoleMode(console, &mode))
+            SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+#endif
+        std::cout.rdbuf(&output);
+        std::cerr.rdbuf(&errors);
+    }
+
+    ~Screen()
+    {
+        std::cout.flush();
+        std::cout.rdbuf(output.underlying());
+        std::cerr.rdbuf(errors.underlying());
+    }
+
+    static std::vector<std::string> splitLines(const std::string &text)
+    {
+        std::vector<std::string> lines;
+        size_t begin = 0;
+        while (true)
+        {
+            size_t end = text.find('\n', begin);
+            if (end == std::string::npos)
+            {
+                lines.push_back(text.substr(begin));
+                return lines;
+            }
+            lines.push_back(text.substr(begin, end - begin));
+            begin = end + 1;
+        }
+    }
+
+    void write(const std::string &text)
+    {
+        output.underlying()->sputn(text.data(), static_cast<std::streamsize>(text.size()));
+        output.underlying()->pubsync();
+        written = 0;
+    }
+
+public:
+    Screen(const Screen &) = delete;
+    Screen &operator=(const Screen &) = delete;
+
+    static Screen &get()
+    {
+        static Screen screen;
+        return screen;
+    }
+
+    // Clears the terminal and moves the cursor home
+    void clear()
+    {
+        std::lock_guard<std::recursive_mutex> lock(guard);
+        std::cout.flush();
+        write("\033[2J\033[H");
+        shown.clear();
+    }
+
+    // Shows the output of `draw` as a full screen, repainting only the
+    // lines that changed since the previous frame
+    template <typename Draw>
+    void frame(Draw draw)
+    {
+        std::lock_guard<std::recursive_mutex> lock(guard);
+        std::cout.flush();
+        bool screenUnchanged = written == 0 && !shown.empty();
+
+        std::ostringstream captured;
+        std::cout.rdbuf(captured.rdbuf());
+        draw();
+        std::cout.rdbuf(&output);
+        std::vector<std::string> lines = splitLines(captured.str());
+
+        std::string update;
+        if (!screenUnchanged)
+        {
+            update = "\033[2J\033[H" + captured.str();
+        }
+        else
+        {
+            size_t last = lines.size() - 1;
+            for (size_t i = 0; i < last; i++)
+            {
+                if (i + 1 < shown.size() && lines[i] == shown[i])
+                    continue;
+                update += "\033[" + std::to_string(i + 1) + ";1H" + lines[i] + "\033[K";
+            }
+            // The prompt line ends with the cursor where input is typed
+            update += "\033[" + std::to_string(last + 1) + ";1H" + lines[last] + "\033[J";
+        }
+        write(update);
+        shown = std::move(lines);
+    }
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+// Container that hands out stable generational handles to its elements.
+// Values are kept densely in insertion order; a handle names a slot that
+// maps to the value's current position, plus the slot's generation. Erasing
+// a value bumps the generation of its slot, so stale handles resolve to
+// nullptr instead of to whatever value moved into the old position.
+template <typename T>
+class SlotMap
+{
+public:
+    struct Handle
+    {
+        uint32_t slot = UINT32_MAX;
+        uint32_t generation = 0;
+
+        bool isNull() const { return slot == UINT32_MAX; }
+        bool operator==(const Handle &other) const { return slot == other.slot && generation == other.generation; }
+        bool operator!=(const Handle &other) const { return !(*this == other); }
+    };
+
+private:
+    struct Slot
+    {
+        uint32_t dense;      // Position of the value in `values`
+        uint32_t generation; // Bumped whenever the slot is freed
+    };
+
+    std::vector<T> values;
+    std::vector<uint32_t> slotOfDense; // Position -> slot
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+
+public:
+    template <typename... Args>
+    Handle emplace(Args &&...args)
+    {
+        uint32_t slot;
+        if (!freeSlots.empty())
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            slot = static_cast<uint32_t>(slots.size());
+            slots.push_back({0, 0});
+        }
+        values.emplace_back(std::forward<Args>(args)...);
+        slotOfDense.push_back(slot);
+        slots[slot].dense = static_cast<uint32_t>(values.size() - 1);
+        return {slot, slots[slot].generation};
+    }
+
+    // The value, or nullptr if the handle is null or its value was erased.
+    // Pointers are only valid until the next emplace or erase; hold handles.
+    T *get(Handle handle)
+    {
+        if (handle.slot >= slots.size() || slots[handle.slot].generation != handle.generation)
+            return nullptr;
+        return &values[slots[handle.slot].dense];
+    }
+
+    const T *get(Handle handle) const
+    {
+        return const_cast<SlotMap *>(this)->get(handle);
+    }
+
+    // Handle of the value at a position in iteration order
+    Handle handleAt(size_t position) const
+    {
+        uint32_t slot = slotOfDense[position];
+        return {slot, slots[slot].generation};
+    }
+
+    // Removes the value; later values keep their relative order
+    bool erase(Handle handle)
+    {
+        if (!get(handle))
+            return false;
+        uint32_t position = slots[handle.slot].dense;
+        values.erase(values.begin() + position);
+        slotOfDense.erase(slotOfDense.begin() + position);
+        for (size_t i = position; i < slotOfDense.size(); i++)
+            slots[slotOfDense[i]].dense = static_cast<uint32_t>(i);
+        slots[handle.slot].generation++;
+        freeSlots.push_back(handle.slot);
+        return true;
+    }
+
+    void clear()
+    {
+        for (uint32_t slot : slotOfDense)
+        {
+            slots[slot].generation++;
+            freeSlots.push_back(slot);
+        }
+        values.clear();
+        slotOfDense.clear();
+    }
+
+    size_t size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+
+    typename std::vector<T>::iterator begin() { return values.begin(); }
+    typename std::vector<T>::iterator end() { return values.end(); }
+    typename std::vector<T>::const_iterator begin() const { return values.begin(); }
+    typename std::vector<T>::const_iterator end() const { return values.end(); }
+};
+
+#endif
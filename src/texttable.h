@@ -0,0 +1,114 @@
+#ifndef TEXTTABLE_H
+#define TEXTTABLE_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ostream>
+#include <algorithm>
+#include <initializer_list>
+
+// Rows of plain text cells kept back to back in one string, with a renderer
+// that needs no per-cell objects: one pass measures the columns, a second
+// formats the rows into a buffer that is written out a page at a time.
+// Meant for result sets too large for tabulate's cell model.
+class TextTable
+{
+private:
+    std::string text;             // All cells, back to back
+    std::vector<size_t> cellEnds; // Offset in `text` where each cell ends
+    size_t columnCount;
+
+    // Columns taken on a terminal; UTF-8 continuation bytes take none
+    static size_t displayWidth(std::string_view cell)
+    {
+        return static_cast<size_t>(std::count_if(cell.begin(), cell.end(), [](char ch)
+                                                  { return (static_cast<unsigned char>(ch) & 0xC0) != 0x80; }));
+    }
+
+public:
+    static constexpr size_t rowsPerWrite = 256;
+
+    explicit TextTable(std::initializer_list<std::string_view> header) : columnCount(header.size())
+    {
+        addRow(header);
+    }
+
+    // Missing trailing cells are left empty; extra cells are dropped
+    void addRow(std::initializer_list<std::string_view> cells)
+    {
+        size_t column = 0;
+        for (std::string_view cell : cells)
+        {
+            if (column++ == columnCount)
+                break;
+            text.append(cell.data(), cell.size());
+            cellEnds.push_back(text.size());
+        }
+        for (; column < columnCount; column++)
+            cellEnds.push_back(text.size());
+    }
+
+    // Number of rows, counting the header
+    size_t size() const { return cellEnds.size() / columnCount; }
+    size_t columns() const { return columnCount; }
+
+    std::string_view cell(size_t row, size_t column) const
+    {
+        size_t index = row * columnCount + column;
+        size_t begin = index == 0 ? 0 : cellEnds[index - 1];
+        return std::string_view(text).substr(begin, cellEnds[index] - begin);
+    }
+
+    void render(std::ostream &out) const
+    {
+        std::vector<size_t> widths(columnCount, 0);
+        for (size_t row = 0; row < size(); row++)
+        {
+            for (size_t column = 0; column < columnCount; column++)
+                widths[column] = std::max(widths[column], displayWidth(cell(row, column)));
+        }
+
+        std::string rule = "+";
+        for (size_t width : widths)
+            rule.append(width + 2, '-').push_back('+');
+        rule.push_back('\n');
+
+        std::string page;
+        page.reserve(rule.size() * (rowsPerWrite + 3));
+        auto appendRow = [&](size_t row)
+        {
+            page.push_back('|');
+            for (size_t column = 0; column < columnCount; column++)
+            {
+                std::string_view value = cell(row, column);
+                page.push_back(' ');
+                if (row == 0)
+                    page.append("\033[1;33m");
+                page.append(value.data(), value.size());
+                if (row == 0)
+                    page.append("\033[0m");
+                page.append(widths[column] - displayWidth(value) + 1, ' ');
+                page.push_back('|');
+            }
+            page.push_back('\n');
+        };
+
+        page += rule;
+        appendRow(0);
+        page += rule;
+        for (size_t row = 1; row < size(); row++)
+        {
+            appendRow(row);
+            if (row % rowsPerWrite == 0)
+            {
+                out.write(page.data(), static_cast<std::streamsize>(page.size()));
+                page.clear();
+            }
+        }
+        page += rule;
+        out.write(page.data(), static_cast<std::streamsize>(page.size()));
+        out.flush();
+    }
+};
+
+#endif